@@ -21,13 +21,16 @@ along with this program.  If not, see https://www.gnu.org/licenses/.
 
 #include "ILI9486.h"
 
-ILI9486::ILI9486(uint8_t CS, uint8_t BL, uint8_t RST, uint8_t DC, Orientation orientation, uint8_t defaultBacklight, ILI9486_COLOR background):
+ILI9486::ILI9486(uint8_t CS, uint8_t BL, uint8_t RST, uint8_t DC, Orientation orientation, uint8_t defaultBacklight, ILI9486_COLOR background, bool clearScreen):
 	CS(CS),
 	BL(BL),
 	RST(RST),
 	DC(DC),
 	defaultBacklight(defaultBacklight),
-	background(background)
+	background(background),
+	readStarted(false),
+	clipDepth(0),
+	clipping(false)
 {
 	// Configure Arduino pins needed for communication
 	pinMode(this->CS, OUTPUT);
@@ -50,7 +53,9 @@ ILI9486::ILI9486(uint8_t CS, uint8_t BL, uint8_t RST, uint8_t DC, Orientation or
 
 	// Turn on the LCD display
 	this->writeRegister(0x29);
-	this->clear();
+	if (clearScreen) {
+		this->clear();
+	}
 	this->setDefaultBacklight();
 }
 
@@ -70,6 +75,14 @@ uint16_t ILI9486::getDefaultBacklight() {
 	return this->defaultBacklight;
 }
 
+uint16_t ILI9486::getCharWidth(FontSize size) {
+	return this->getFont(size)->Width;
+}
+
+uint16_t ILI9486::getCharHeight(FontSize size) {
+	return this->getFont(size)->Height;
+}
+
 void ILI9486::setBacklight(uint8_t value) {
 	analogWrite(this->BL, value);
 }
@@ -90,7 +103,10 @@ void ILI9486::changeBackground(ILI9486_COLOR color) {
 	this->background = color;
 }
 
-void ILI9486::fill(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, ILI9486_COLOR color) {
+void ILI9486::fill(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color) {
+	// Rectangle is clipped before window is opened, so no pixel outside clip is sent
+	if (!this->clipRect(&xStart, &yStart, &xEnd, &yEnd)) { return; }
+
 	// Number of pixels inside rectangle
 	uint32_t size = (uint32_t)(xEnd - xStart) * (uint32_t)(yEnd - yStart);
 
@@ -100,7 +116,8 @@ void ILI9486::fill(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEn
 }
 
 void ILI9486::clear(ILI9486_COLOR color) {
-	fill(0, 0, this->width, this->height, color);
+	// Clip rectangle is given relative to origin
+	fill(this->clip.xStart - this->clip.originX, this->clip.yStart - this->clip.originY, this->clip.xEnd - this->clip.originX, this->clip.yEnd - this->clip.originY, color);
 }
 
 void ILI9486::clear() {
@@ -108,33 +125,7 @@ void ILI9486::clear() {
 }
 
 void ILI9486::openWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
-	// Ensure that coordinates are given in correct order
-	if (xStart > xEnd) {
-		uint16_t tmp = xStart;
-		xStart = xEnd;
-		xEnd = tmp;
-	}
-
-	if (yStart > yEnd) {
-		uint16_t tmp = yStart;
-		yStart = yEnd;
-		yEnd = tmp;
-	}
-
-	// Set the X coordinates
-	this->writeRegister(0x2A);
-	this->writeData(xStart >> 8); // Set the horizontal starting point to the high octet
-	this->writeData(xStart & 0xff);	// Set the horizontal starting point to the low octet
-	this->writeData((xEnd - 1) >> 8); // Set the horizontal end to the high octet
-	this->writeData((xEnd - 1) & 0xff); // Set the horizontal end to the low octet
-
-	// Set the Y coordinates
-	this->writeRegister(0x2B);
-	this->writeData(yStart >> 8);
-	this->writeData(yStart & 0xff );
-	this->writeData((yEnd - 1) >> 8);
-	this->writeData((yEnd - 1) & 0xff);
-	
+	this->setWindow(xStart, yStart, xEnd, yEnd);
 	this->writeRegister(0x2C);
 }
 
@@ -143,33 +134,168 @@ void ILI9486::setCursor(uint16_t x, uint16_t y) {
 }
 
 void ILI9486::writeColor(ILI9486_COLOR color, uint32_t n) {
-	digitalWrite(this->DC, 1);
-	digitalWrite(this->CS, 0);
+	this->beginWrite();
 
 	for (uint32_t i = 0; i < n; i++) {
 		SPI.transfer16(color);
 	}
 
-	digitalWrite(this->CS, 1);
+	this->endWrite();
 }
 
-void ILI9486::writeBuffer(ILI9486_COLOR *buffer, uint32_t n) {
-	digitalWrite(this->DC, 1);
-	digitalWrite(this->CS, 0);
+void ILI9486::writeBuffer(const ILI9486_COLOR *buffer, uint32_t n) {
+	this->beginWrite();
 
+#ifdef ILI9486_SPI_STAGING
+	// Colors are swapped into SPI byte order directly in queue
+	uint32_t limit = SPI.getMessageSize() / 2;
+
+	while (n > 0) {
+		uint32_t chunk = n < limit ? n : limit;
+		uint8_t *bytes = SPI.reserve(chunk * 2);
+
+		for (uint32_t i = 0; i < chunk; i++) {
+			bytes[i * 2] = buffer[i] >> 8;
+			bytes[i * 2 + 1] = buffer[i];
+		}
+
+		buffer += chunk;
+		n -= chunk;
+	}
+#else
 	for (uint32_t i = 0; i < n; i++) {
 		SPI.transfer16(buffer[i]);
 	}
+#endif
 
-	digitalWrite(this->CS, 1);
+	this->endWrite();
+}
+
+void ILI9486::writeBytes(const uint8_t *buffer, uint32_t n) {
+	this->beginWrite();
+
+#ifdef ILI9486_SPI_STAGING
+	// Bytes are already in SPI order, message points to them
+	SPI.write(buffer, n * 2);
+#else
+	for (uint32_t i = 0; i < n; i++) {
+		SPI.transfer16(((uint16_t)buffer[i * 2] << 8) | buffer[i * 2 + 1]);
+	}
+#endif
+
+	this->endWrite();
 }
 
-void ILI9486::setPixel(uint16_t x, uint16_t y, ILI9486_COLOR color) {
-	this->setCursor(x, y);
+void ILI9486::setPixel(int16_t x, int16_t y, ILI9486_COLOR color) {
+	int32_t screenX = (int32_t)x + this->clip.originX;
+	int32_t screenY = (int32_t)y + this->clip.originY;
+	if (screenX < this->clip.xStart || screenX >= this->clip.xEnd || screenY < this->clip.yStart || screenY >= this->clip.yEnd) { return; }
+
+	this->setCursor(screenX, screenY);
 	this->writeColor(color, 1);
 }
 
-void ILI9486::drawCircle(uint16_t x, uint16_t y, uint16_t radius, ILI9486_COLOR color, bool filled) {
+void ILI9486::openReadWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+	this->setWindow(xStart, yStart, xEnd, yEnd);
+	this->readStarted = false;
+}
+
+void ILI9486::readBuffer(ILI9486_COLOR *buffer, uint32_t n) {
+	// Memory read (0x2E) starts at area origin, memory read continue (0x3E) resumes after last pixel read
+	this->beginRead(this->readStarted ? 0x3E : 0x2E);
+	this->readStarted = true;
+
+	// Pixels are always read in 18 bit format, one byte per component with 6 significant bits
+	uint8_t chunk[3 * ILI9486_TRANSFER_CHUNK];
+	for (uint32_t i = 0; i < n; i += ILI9486_TRANSFER_CHUNK) {
+		uint32_t len = (n - i < ILI9486_TRANSFER_CHUNK) ? (n - i) : ILI9486_TRANSFER_CHUNK;
+		memset(chunk, 0x00, 3 * len);
+		SPI.transfer(chunk, 3 * len); // Buffered transfer, bytes shifted out are replaced with bytes read
+
+		for (uint32_t j = 0; j < len; j++) {
+			const uint8_t *rgb = chunk + 3 * j;
+			buffer[i + j] = ((uint16_t)(rgb[0] & 0xF8) << 8) | ((uint16_t)(rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+		}
+	}
+
+	digitalWrite(this->CS, 1);
+}
+
+ILI9486_COLOR ILI9486::getPixel(uint16_t x, uint16_t y) {
+	ILI9486_COLOR color;
+
+	this->openReadWindow(x, y, x + 1, y + 1);
+	this->readBuffer(&color, 1);
+
+	return color;
+}
+
+void ILI9486::readRegister(uint8_t reg, uint8_t *buffer, uint8_t n) {
+	this->beginRead(reg);
+
+	memset(buffer, 0x00, n);
+	SPI.transfer(buffer, n);
+
+	digitalWrite(this->CS, 1);
+}
+
+uint32_t ILI9486::readID() {
+	uint8_t id[3];
+	this->readRegister(0x04, id, 3);
+
+	// Manufacturer ID, driver version ID, driver ID
+	return ((uint32_t)id[0] << 16) | ((uint32_t)id[1] << 8) | id[2];
+}
+
+void ILI9486::saveRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, ILI9486_COLOR *buffer) {
+	this->openReadWindow(xStart, yStart, xEnd, yEnd);
+	this->readBuffer(buffer, (uint32_t)(xEnd - xStart) * (uint32_t)(yEnd - yStart));
+}
+
+void ILI9486::saveRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, ILI9486_COLOR *buffer, const ILI9486_COLOR *framebuffer) {
+	uint16_t w = xEnd - xStart;
+
+	// Framebuffer rows are getWidth() pixels long
+	for (uint16_t y = yStart; y < yEnd; y++) {
+		memcpy(buffer, &framebuffer[(uint32_t)y * this->width + xStart], w * sizeof(ILI9486_COLOR));
+		buffer += w;
+	}
+}
+
+void ILI9486::saveRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, File &file) {
+	ILI9486_COLOR chunk[ILI9486_TRANSFER_CHUNK];
+	uint32_t n = (uint32_t)(xEnd - xStart) * (uint32_t)(yEnd - yStart);
+
+	this->openReadWindow(xStart, yStart, xEnd, yEnd);
+
+	// SD card shares SPI bus, so GRAM read is released after every chunk
+	for (uint32_t i = 0; i < n; i += ILI9486_TRANSFER_CHUNK) {
+		uint32_t len = (n - i < ILI9486_TRANSFER_CHUNK) ? (n - i) : ILI9486_TRANSFER_CHUNK;
+		this->readBuffer(chunk, len);
+		file.write((const uint8_t*)chunk, len * sizeof(ILI9486_COLOR));
+	}
+}
+
+void ILI9486::restoreRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, const ILI9486_COLOR *buffer) {
+	this->openWindow(xStart, yStart, xEnd, yEnd);
+	this->writeBuffer(buffer, (uint32_t)(xEnd - xStart) * (uint32_t)(yEnd - yStart));
+}
+
+void ILI9486::restoreRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, File &file) {
+	ILI9486_COLOR chunk[ILI9486_TRANSFER_CHUNK];
+	uint32_t n = (uint32_t)(xEnd - xStart) * (uint32_t)(yEnd - yStart);
+
+	// Window is opened once, following data writes continue where previous chunk ended
+	this->openWindow(xStart, yStart, xEnd, yEnd);
+
+	for (uint32_t i = 0; i < n; i += ILI9486_TRANSFER_CHUNK) {
+		uint32_t len = (n - i < ILI9486_TRANSFER_CHUNK) ? (n - i) : ILI9486_TRANSFER_CHUNK;
+		file.read((uint8_t*)chunk, len * sizeof(ILI9486_COLOR));
+		this->writeBuffer(chunk, len);
+	}
+}
+
+void ILI9486::drawCircle(int16_t x, int16_t y, uint16_t radius, ILI9486_COLOR color, bool filled) {
 	// Bresenham's Circle Algorithm
 	// See: https://www.javatpoint.com/computer-graphics-bresenhams-circle-algorithm
 	int32_t r = (uint32_t)radius;
@@ -219,15 +345,15 @@ void ILI9486::drawCircle(uint16_t x, uint16_t y, uint16_t radius, ILI9486_COLOR
 	}
 }
 
-void ILI9486::drawHLine(uint16_t x, uint16_t y, uint16_t len, ILI9486_COLOR color) {
+void ILI9486::drawHLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color) {
 	this->fill(x, y, x + len, y + 1, color);
 }
 
-void ILI9486::drawVLine(uint16_t x, uint16_t y, uint16_t len, ILI9486_COLOR color) {
+void ILI9486::drawVLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color) {
 	this->fill(x, y, x + 1, y + len, color);
 }
 
-void ILI9486::drawLine(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, ILI9486_COLOR color) {
+void ILI9486::drawLine(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color) {
 	// Bresenham's Line Algorithm
 	// See: https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
 	int32_t dx = abs((int32_t)xEnd - (int32_t)xStart);
@@ -262,53 +388,351 @@ void ILI9486::drawLine(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t
 	}
 }
 
-void ILI9486::drawChar(uint16_t x, uint16_t y, uint8_t character, FontSize size, ILI9486_COLOR color) {
-	// Load correct font size
-	sFONT *font;
-	switch(size) {
-		case XS: font = &Font8; break;
-		case S: font = &Font12; break;
-		case M: font = &Font16; break;
-		case L: font = &Font20; break;
-		case XL: font = &Font24; break;
-	}
+void ILI9486::drawChar(int16_t x, int16_t y, uint8_t character, FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	const sFONT *font = this->getFont(size);
+	const uint8_t *glyph = this->getGlyph(font, character);
+	uint8_t bytesPerLine = (font->Width + 7) / 8;
 	
-	// Modify position to top left corner of character
-	x -= (font->Width / 2);
-	y += (font->Height / 2);
+	// Modify position to top left corner of character, every font pixel is scale x scale block
+	x -= (font->Width * scale / 2);
+	y += (font->Height * scale / 2);
 
-	// Calculate character position in memory
-	uint32_t pos = uint32_t(character - ' ') * font->Height;
-	// Some fonts have use more then 8 bits for one pixel line
-	pos *= ( font->Width / 8 + ((font->Width % 8) ? 1 : 0) );
+	// Runs are clipped by fill, whole cell outside clip is skipped without reading font
+	int16_t xStart = x, yStart = y + 1 - font->Height * scale, xEnd = x + font->Width * scale, yEnd = y + 1;
+	if (!this->clipRect(&xStart, &yStart, &xEnd, &yEnd)) { return; }
+
+	for (uint16_t i = 0; i < font->Height; ) {
+		const uint8_t *line = glyph + i * bytesPerLine;
+
+		// Identical following lines are drawn together as one taller band
+		uint16_t lines = 1;
+		while (i + lines < font->Height && memcmp_P(line, line + lines * bytesPerLine, bytesPerLine) == 0) {
+			lines++;
+		}
+
+		// Band covers display lines from y - (i + lines) * scale + 1 to y - i * scale
+		int16_t bandEnd = y - i * scale + 1;
+		int16_t bandStart = bandEnd - lines * scale;
+
+		// Every run of set pixels is written with one window
+		for (uint16_t j = 0; j < font->Width; ) {
+			if (!(pgm_read_byte(&line[j / 8]) & (0x80 >> (j % 8)))) {
+				j++;
+				continue;
+			}
+
+			uint16_t runStart = j;
+			while (j < font->Width && (pgm_read_byte(&line[j / 8]) & (0x80 >> (j % 8)))) {
+				j++;
+			}
+
+			this->fill(x + runStart * scale, bandStart, x + j * scale, bandEnd, color);
+		}
+
+		i += lines;
+	}
+}
+
+void ILI9486::drawString(int16_t x, int16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	this->drawStringFrom(x, y, str, false, size, color, scale);
+}
+
+void ILI9486::drawString(int16_t x, int16_t y, const __FlashStringHelper *str, FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	this->drawStringFrom(x, y, reinterpret_cast<const uint8_t*>(str), true, size, color, scale);
+}
+
+void ILI9486::drawString_P(int16_t x, int16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	this->drawStringFrom(x, y, str, true, size, color, scale);
+}
+
+void ILI9486::drawText(int16_t x, int16_t y, const uint8_t *str, uint16_t length, FontSize size, ILI9486_COLOR color, ILI9486_COLOR background, Rotation rotation) {
+	const sFONT *font = this->getFont(size);
+	const uint8_t *end = str + length;
+	uint8_t bytesPerLine = (font->Width + 7) / 8;
+
+	// Count characters to get window width, end is moved to the last decoded byte
+	uint16_t count = 0;
+	const uint8_t *p = str;
+	while (p < end && *p != '\0') {
+		decodeUTF8(&p);
+		count++;
+	}
+	end = p;
+
+	if (count == 0) { return; }
+
+	// Window is scanned along x and then along y, for vertical text MADCTL row / column exchange bit is toggled,
+	// so window is scanned along y and then along x. Character lines and columns are streamed in order matching scan
+	// direction, so rotated text is written in one burst like horizontal one.
+	uint16_t textWidth = font->Width * count;
+	bool transposed = rotation == ROTATE_90 || rotation == ROTATE_270;
+	bool reversedLines = rotation == ROTATE_0 || rotation == ROTATE_270; // Lines are stored in order opposite to scan
+	bool reversedText = rotation == ROTATE_180 || rotation == ROTATE_270; // Characters and their columns are streamed from the end
+
+	// (x, y) is center of first character, like in drawString
+	int16_t xStart, yStart;
+	switch (rotation) {
+	case ROTATE_0:
+		xStart = x - (font->Width / 2);
+		yStart = y + (font->Height / 2) + 1 - font->Height;
+		break;
+	case ROTATE_90:
+		xStart = x - (font->Height / 2);
+		yStart = y - (font->Width / 2);
+		break;
+	case ROTATE_180:
+		xStart = x + (font->Width / 2) + 1 - textWidth;
+		yStart = y - (font->Height / 2);
+		break;
+	default:
+		xStart = x + (font->Height / 2) + 1 - font->Height;
+		yStart = y + (font->Width / 2) + 1 - textWidth;
+		break;
+	}
+
+	bool visible;
+	if (transposed) {
+		visible = this->openClippedWindow(xStart, yStart, xStart + font->Height, yStart + textWidth, true);
+	} else {
+		visible = this->openClippedWindow(xStart, yStart, xStart + textWidth, yStart + font->Height);
+	}
+
+	if (!visible) { return; }
+
+	this->beginWrite();
+
+	// Window line crosses all characters
+	for (uint16_t n = 0; n < font->Height; n++) {
+		uint16_t i = reversedLines ? font->Height - 1 - n : n;
+		p = reversedText ? end : str;
+
+		for (uint16_t k = 0; k < count; k++) {
+			uint8_t character;
+			if (reversedText) {
+				p = previousUTF8(str, p);
+				const uint8_t *q = p;
+				character = cellChar(decodeUTF8(&q));
+			} else {
+				character = cellChar(decodeUTF8(&p));
+			}
+
+			const uint8_t *line = this->getGlyph(font, character) + i * bytesPerLine;
+
+			for (uint16_t m = 0; m < font->Width; m++) {
+				uint16_t j = reversedText ? font->Width - 1 - m : m;
+				this->writePixel((pgm_read_byte(&line[j / 8]) & (0x80 >> (j % 8))) ? color : background);
+			}
+		}
+	}
+
+	this->endWrite();
+
+	if (transposed) {
+		this->writeRegister(0x36);
+		this->writeData(this->memoryAccess);
+	}
+}
+
+void ILI9486::expandChar(uint8_t character, FontSize size, ILI9486_COLOR color, ILI9486_COLOR background, ILI9486_COLOR *cell) {
+	const sFONT *font = this->getFont(size);
+	const uint8_t *glyph = this->getGlyph(font, character);
+	uint8_t bytesPerLine = (font->Width + 7) / 8;
+
+	// Character lines are stored in reversed order relative to window
+	for (int16_t i = font->Height - 1; i >= 0; i--) {
+		const uint8_t *line = glyph + i * bytesPerLine;
 
-	for (uint16_t i = 0; i < font->Height; i++) {
 		for (uint16_t j = 0; j < font->Width; j++) {
-			// Some fonts use more than 8 bits for one pixel line
-			if ( (j % 8 == 0) && (j != 0) ) { pos++; }
+			*cell++ = (pgm_read_byte(&line[j / 8]) & (0x80 >> (j % 8))) ? color : background;
+		}
+	}
+}
+
+void ILI9486::drawCell(int16_t x, int16_t y, FontSize size, const ILI9486_COLOR *cell) {
+	const sFONT *font = this->getFont(size);
+	if (!this->openCharWindow(font->Width, font->Height, x, y)) { return; }
+
+	if (!this->clipping) {
+		this->writeBuffer(cell, (uint32_t)font->Width * font->Height);
+		return;
+	}
+
+	// Window covers only visible part, its rows are parts of cell rows
+	for (uint16_t row = this->visibleTop; row < this->visibleBottom; row++) {
+		this->writeBuffer(cell + row * font->Width + this->visibleLeft, this->visibleRight - this->visibleLeft);
+	}
+
+	this->clipping = false;
+}
+
+void ILI9486::drawChar(int16_t x, int16_t y, uint8_t character, const sAAFONT &font, ILI9486_COLOR color, ILI9486_COLOR background) {
+	ILI9486_COLOR ramp[16];
+	blendRamp(color, background, ramp, 1 << font.Bpp);
 
-			// Font is saved in FLASH memory
-			if (pgm_read_byte(&font->table[pos]) & (0x80 >> (j % 8))) {
-				this->setPixel(x + j, y - i, color);
+	this->drawGlyph(x, y, character, font, ramp);
+}
+
+void ILI9486::drawString(int16_t x, int16_t y, const uint8_t *str, const sAAFONT &font, ILI9486_COLOR color, ILI9486_COLOR background) {
+	this->drawStringFrom(x, y, str, false, font, color, background);
+}
+
+void ILI9486::drawString(int16_t x, int16_t y, const __FlashStringHelper *str, const sAAFONT &font, ILI9486_COLOR color, ILI9486_COLOR background) {
+	this->drawStringFrom(x, y, reinterpret_cast<const uint8_t*>(str), true, font, color, background);
+}
+
+void ILI9486::drawChar(int16_t x, int16_t y, uint32_t character, const sPFONT &font, ILI9486_COLOR color, ILI9486_COLOR background) {
+	sGLYPH glyph;
+	uint16_t index;
+	if (!this->getGlyph(font, character, &glyph, &index)) { return; }
+
+	ILI9486_COLOR ramp[16];
+	blendRamp(color, background, ramp, 1 << font.Bpp);
+
+	this->drawGlyph(x, y, glyph, font, ramp);
+}
+
+void ILI9486::drawString(int16_t x, int16_t y, const uint8_t *str, const sPFONT &font, ILI9486_COLOR color, ILI9486_COLOR background) {
+	this->drawStringFrom(x, y, str, false, font, color, background);
+}
+
+void ILI9486::drawString(int16_t x, int16_t y, const __FlashStringHelper *str, const sPFONT &font, ILI9486_COLOR color, ILI9486_COLOR background) {
+	this->drawStringFrom(x, y, reinterpret_cast<const uint8_t*>(str), true, font, color, background);
+}
+
+void ILI9486::fill(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR background) {
+	// Background is uniform, so blended color is computed once
+	this->fill(xStart, yStart, xEnd, yEnd, blend(color, background, alpha));
+}
+
+void ILI9486::fillFB(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR *framebuffer) {
+	// Framebuffer is addressed with clipped screen coordinates
+	if (!this->clipRect(&xStart, &yStart, &xEnd, &yEnd)) { return; }
+
+	uint8_t r[32], g[64], b[32];
+	blendTables(color, alpha, r, g, b);
+
+	this->openWindow(xStart, yStart, xEnd, yEnd);
+	this->beginWrite();
+
+	for (int16_t y = yStart; y < yEnd; y++) {
+		ILI9486_COLOR *row = &framebuffer[(uint32_t)y * this->width];
+
+		for (int16_t x = xStart; x < xEnd; x++) {
+			row[x] = blendLookup(row[x], r, g, b);
+			SPI.transfer16(row[x]);
+		}
+	}
+
+	this->endWrite();
+}
+
+void ILI9486::drawHLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR background) {
+	this->fill(x, y, x + len, y + 1, color, alpha, background);
+}
+
+void ILI9486::drawHLineFB(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR *framebuffer) {
+	this->fillFB(x, y, x + len, y + 1, color, alpha, framebuffer);
+}
+
+void ILI9486::drawChar(int16_t x, int16_t y, uint8_t character, FontSize size, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR background) {
+	const sFONT *font = this->getFont(size);
+	const uint8_t *glyph = this->getGlyph(font, character);
+	uint8_t bytesPerLine = (font->Width + 7) / 8;
+
+	// Colors of unset and set pixel
+	ILI9486_COLOR ramp[2] = {background, blend(color, background, alpha)};
+
+	if (!this->openCharWindow(font->Width, font->Height, x, y)) { return; }
+	this->beginWrite();
+
+	// Character lines are stored in reversed order relative to window
+	for (int16_t i = font->Height - 1; i >= 0; i--) {
+		const uint8_t *line = glyph + i * bytesPerLine;
+
+		for (uint16_t j = 0; j < font->Width; j++) {
+			uint8_t bit = (pgm_read_byte(&line[j / 8]) >> (7 - (j % 8))) & 0x01;
+			this->writePixel(ramp[bit]);
+		}
+	}
+
+	this->endWrite();
+}
+
+void ILI9486::drawCharFB(int16_t x, int16_t y, uint8_t character, FontSize size, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR *framebuffer) {
+	const sFONT *font = this->getFont(size);
+	const uint8_t *glyph = this->getGlyph(font, character);
+	uint8_t bytesPerLine = (font->Width + 7) / 8;
+
+	uint8_t r[32], g[64], b[32];
+	blendTables(color, alpha, r, g, b);
+
+	// Cell is clipped in screen coordinates, only its visible lines and columns are blended and sent
+	int16_t left = x - (font->Width / 2);
+	int16_t top = y + (font->Height / 2) - (font->Height - 1);
+	int16_t xStart = left, yStart = top, xEnd = left + font->Width, yEnd = top + font->Height;
+	if (!this->clipRect(&xStart, &yStart, &xEnd, &yEnd)) { return; }
+
+	left += this->clip.originX;
+	top += this->clip.originY;
+
+	this->openWindow(xStart, yStart, xEnd, yEnd);
+	this->beginWrite();
+
+	// Character lines are stored in reversed order relative to window
+	for (int16_t i = top + font->Height - 1 - yStart; i >= top + font->Height - yEnd; i--) {
+		const uint8_t *line = glyph + i * bytesPerLine;
+		ILI9486_COLOR *row = &framebuffer[(uint32_t)(top + font->Height - 1 - i) * this->width];
+
+		for (int16_t x = xStart; x < xEnd; x++) {
+			uint16_t j = x - left;
+			if (pgm_read_byte(&line[j / 8]) & (0x80 >> (j % 8))) {
+				row[x] = blendLookup(row[x], r, g, b);
 			}
+
+			SPI.transfer16(row[x]);
 		}
+	}
 
-		pos++;
+	this->endWrite();
+}
+
+void ILI9486::drawString(int16_t x, int16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR background) {
+	uint16_t width = this->getFont(size)->Width;
+
+	while (*str != '\0') {
+		this->drawChar(x, y, cellChar(decodeUTF8(&str)), size, color, alpha, background);
+		x += width;
 	}
 }
 
-void ILI9486::drawString(uint16_t x, uint16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color) {
-	for (uint16_t i = 0; str[i] != '\0'; i++) {
-		this->drawChar(x, y, str[i], size, color);
+void ILI9486::drawStringFB(int16_t x, int16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR *framebuffer) {
+	uint16_t width = this->getFont(size)->Width;
 
-		// Move x for next letter depending on font size
-		switch(size) {
-			case XS: x += Font8.Width; break;
-			case S: x += Font12.Width; break;
-			case M: x += Font16.Width; break;
-			case L: x += Font20.Width; break;
-			case XL: x += Font24.Width; break;
-		}	
+	while (*str != '\0') {
+		this->drawCharFB(x, y, cellChar(decodeUTF8(&str)), size, color, alpha, framebuffer);
+		x += width;
+	}
+}
+
+ILI9486_COLOR ILI9486::blend(ILI9486_COLOR fg, ILI9486_COLOR bg, uint8_t alpha) {
+	// Fixed point blend of every channel, v / 255 computed as (v + 128 + ((v + 128) >> 8)) >> 8
+	uint16_t result = 0;
+	const uint8_t shift[3] = {11, 5, 0};
+	const uint8_t mask[3] = {0x1F, 0x3F, 0x1F};
+
+	for (uint8_t c = 0; c < 3; c++) {
+		uint16_t f = (fg >> shift[c]) & mask[c];
+		uint16_t b = (bg >> shift[c]) & mask[c];
+		uint16_t v = f * alpha + b * (255 - alpha) + 128;
+		result |= ((v + (v >> 8)) >> 8) << shift[c];
+	}
+
+	return result;
+}
+
+void ILI9486::blendRamp(ILI9486_COLOR fg, ILI9486_COLOR bg, ILI9486_COLOR *ramp, uint8_t levels) {
+	for (uint8_t i = 0; i < levels; i++) {
+		ramp[i] = blend(fg, bg, (uint16_t)i * 255 / (levels - 1));
 	}
 }
 
@@ -440,6 +864,442 @@ void ILI9486::writeData(uint8_t data) {
 	digitalWrite(this->CS, 1);
 }
 
+void ILI9486::drawStringFrom(int16_t x, int16_t y, const uint8_t *str, bool progmem, FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	// Move x for next letter depending on font size
+	uint16_t width = this->getFont(size)->Width * scale;
+
+	// Characters right of clip are never visible, rest of string is not decoded
+	int16_t right = this->clip.xEnd - this->clip.originX + width / 2;
+
+	while (readByte(str, progmem) != '\0' && x < right) {
+		this->drawChar(x, y, cellChar(decodeUTF8(&str, progmem)), size, color, scale);
+		x += width;
+	}
+}
+
+void ILI9486::drawStringFrom(int16_t x, int16_t y, const uint8_t *str, bool progmem, const sAAFONT &font, ILI9486_COLOR color, ILI9486_COLOR background) {
+	// Ramp is computed once for whole string
+	ILI9486_COLOR ramp[16];
+	blendRamp(color, background, ramp, 1 << font.Bpp);
+
+	int16_t right = this->clip.xEnd - this->clip.originX + font.Width / 2;
+
+	while (readByte(str, progmem) != '\0' && x < right) {
+		this->drawGlyph(x, y, cellChar(decodeUTF8(&str, progmem)), font, ramp);
+		x += font.Width;
+	}
+}
+
+void ILI9486::drawStringFrom(int16_t x, int16_t y, const uint8_t *str, bool progmem, const sPFONT &font, ILI9486_COLOR color, ILI9486_COLOR background) {
+	ILI9486_COLOR ramp[16];
+	blendRamp(color, background, ramp, 1 << font.Bpp);
+
+	bool hasPrevious = false;
+	uint16_t previous = 0;
+
+	while (readByte(str, progmem) != '\0') {
+		sGLYPH glyph;
+		uint16_t index;
+		if (!this->getGlyph(font, decodeUTF8(&str, progmem), &glyph, &index)) { continue; }
+
+		if (hasPrevious) {
+			x += this->getKerning(font, previous, index);
+		}
+
+		this->drawGlyph(x, y, glyph, font, ramp);
+		x += glyph.xAdvance;
+
+		hasPrevious = true;
+		previous = index;
+	}
+}
+
+void ILI9486::beginWrite() {
+	digitalWrite(this->DC, 1);
+	digitalWrite(this->CS, 0);
+}
+
+void ILI9486::endWrite() {
+	digitalWrite(this->CS, 1);
+}
+
+const sFONT *ILI9486::getFont(FontSize size) {
+	switch(size) {
+		case XS: return &Font8;
+		case S: return &Font12;
+		case M: return &Font16;
+		case L: return &Font20;
+		default: return &Font24;
+	}
+}
+
+bool ILI9486::openCharWindow(uint16_t width, uint16_t height, int16_t x, int16_t y) {
+	// (x, y) is center of character, lines are drawn upwards from y + height / 2
+	int16_t left = x - (width / 2);
+	int16_t bottom = y + (height / 2);
+
+	return this->openClippedWindow(left, bottom + 1 - height, left + width, bottom + 1);
+}
+
+bool ILI9486::clipRect(int16_t *xStart, int16_t *yStart, int16_t *xEnd, int16_t *yEnd) {
+	// Coordinates may be given in any order, like in setWindow
+	int32_t left = (int32_t)*xStart + this->clip.originX;
+	int32_t right = (int32_t)*xEnd + this->clip.originX;
+	int32_t top = (int32_t)*yStart + this->clip.originY;
+	int32_t bottom = (int32_t)*yEnd + this->clip.originY;
+
+	if (left > right) {
+		int32_t tmp = left;
+		left = right;
+		right = tmp;
+	}
+
+	if (top > bottom) {
+		int32_t tmp = top;
+		top = bottom;
+		bottom = tmp;
+	}
+
+	if (left < this->clip.xStart) { left = this->clip.xStart; }
+	if (top < this->clip.yStart) { top = this->clip.yStart; }
+	if (right > this->clip.xEnd) { right = this->clip.xEnd; }
+	if (bottom > this->clip.yEnd) { bottom = this->clip.yEnd; }
+
+	*xStart = left;
+	*yStart = top;
+	*xEnd = right;
+	*yEnd = bottom;
+	return left < right && top < bottom;
+}
+
+bool ILI9486::openClippedWindow(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, bool transposed) {
+	int16_t left = xStart, top = yStart, right = xEnd, bottom = yEnd;
+	if (!this->clipRect(&left, &top, &right, &bottom)) { return false; }
+
+	// Visible part relative to requested window, for transposed window lines are display columns
+	int16_t screenX = xStart + this->clip.originX;
+	int16_t screenY = yStart + this->clip.originY;
+
+	if (transposed) {
+		this->clipWidth = yEnd - yStart;
+		this->visibleLeft = top - screenY;
+		this->visibleRight = bottom - screenY;
+		this->visibleTop = left - screenX;
+		this->visibleBottom = right - screenX;
+
+		// Only write direction changes, B6h register which maps GRAM to panel is untouched, so image does not flicker
+		this->writeRegister(0x36);
+		this->writeData(this->memoryAccess ^ 0x20);
+		this->openWindow(top, left, bottom, right);
+	} else {
+		this->clipWidth = xEnd - xStart;
+		this->visibleLeft = left - screenX;
+		this->visibleRight = right - screenX;
+		this->visibleTop = top - screenY;
+		this->visibleBottom = bottom - screenY;
+		this->openWindow(left, top, right, bottom);
+	}
+
+	this->clipping = right - left != xEnd - xStart || bottom - top != yEnd - yStart;
+	this->clipColumn = 0;
+	this->clipRow = 0;
+	return true;
+}
+
+void ILI9486::writePixel(ILI9486_COLOR color) {
+	if (!this->clipping) {
+		SPI.transfer16(color);
+		return;
+	}
+
+	// Pixels outside visible span of line are skipped
+	if (this->clipRow >= this->visibleTop && this->clipRow < this->visibleBottom && this->clipColumn >= this->visibleLeft && this->clipColumn < this->visibleRight) {
+		SPI.transfer16(color);
+	}
+
+	if (++this->clipColumn == this->clipWidth) {
+		this->clipColumn = 0;
+		this->clipRow++;
+	}
+}
+
+void ILI9486::drawGlyph(int16_t x, int16_t y, uint8_t character, const sAAFONT &font, const ILI9486_COLOR *ramp) {
+	uint8_t bytesPerLine = (font.Width * font.Bpp + 7) / 8;
+	uint8_t mask = (1 << font.Bpp) - 1;
+	const uint8_t *glyph = font.table + (uint32_t)(cellChar(character) - ' ') * font.Height * bytesPerLine;
+
+	if (!this->openCharWindow(font.Width, font.Height, x, y)) { return; }
+	this->beginWrite();
+
+	// Character lines are stored in reversed order relative to window
+	for (int16_t i = font.Height - 1; i >= 0; i--) {
+		const uint8_t *line = glyph + i * bytesPerLine;
+		uint8_t bits = 0;
+		uint8_t left = 0; // Coverage values left in bits
+
+		for (uint16_t j = 0; j < font.Width; j++) {
+			if (left == 0) {
+				bits = pgm_read_byte(line++);
+				left = 8 / font.Bpp;
+			}
+
+			left--;
+			this->writePixel(ramp[(bits >> (left * font.Bpp)) & mask]);
+		}
+	}
+
+	this->endWrite();
+}
+
+void ILI9486::drawGlyph(int16_t x, int16_t y, const sGLYPH &glyph, const sPFONT &font, const ILI9486_COLOR *ramp) {
+	if (glyph.width == 0 || glyph.height == 0) { return; }
+
+	// Top of line is drawn at y + Height / 2, next lines are drawn upwards
+	int16_t left = x + glyph.xOffset;
+	int16_t bottom = y + (font.Height / 2) - glyph.yOffset;
+	if (!this->openClippedWindow(left, bottom + 1 - glyph.height, left + glyph.width, bottom + 1)) { return; }
+
+	const uint8_t *bitmap = font.table + glyph.offset;
+	uint16_t n = (uint16_t)glyph.width * glyph.height;
+
+	// Lines are stored in window order, one continuous stream
+	this->beginWrite();
+
+	if (font.Compression == PFONT_RLE) {
+		this->writeRLE(bitmap, n, font.Bpp, ramp);
+	} else {
+		uint8_t mask = (1 << font.Bpp) - 1;
+		uint8_t bits = 0;
+		uint8_t remaining = 0; // Coverage values left in bits
+
+		for (uint16_t i = 0; i < n; i++) {
+			if (remaining == 0) {
+				bits = pgm_read_byte(bitmap++);
+				remaining = 8 / font.Bpp;
+			}
+
+			remaining--;
+			this->writePixel(ramp[(bits >> (remaining * font.Bpp)) & mask]);
+		}
+	}
+
+	this->endWrite();
+}
+
+void ILI9486::writeRLE(const uint8_t *bitmap, uint16_t n, uint8_t bpp, const ILI9486_COLOR *ramp) {
+	uint8_t value = 0;
+
+	while (n > 0) {
+		uint8_t data = pgm_read_byte(bitmap++);
+		uint8_t runs[2];
+		uint8_t count;
+
+		if (bpp == 1) {
+			// Two runs per byte, colors alternate
+			runs[0] = data >> 4;
+			runs[1] = data & 0x0F;
+			count = 2;
+		} else {
+			value = data >> (8 - bpp);
+			runs[0] = (data & ((1 << (8 - bpp)) - 1)) + 1;
+			count = 1;
+		}
+
+		for (uint8_t r = 0; r < count; r++) {
+			uint8_t run = (runs[r] < n) ? runs[r] : n;
+			n -= run;
+
+			while (run-- > 0) {
+				this->writePixel(ramp[value]);
+			}
+
+			if (bpp == 1) { value ^= 1; }
+		}
+	}
+}
+
+bool ILI9486::getGlyph(const sPFONT &font, uint32_t character, sGLYPH *glyph, uint16_t *index) {
+	if (character < font.First || character > font.Last) { return false; }
+
+	if (font.codepoints == NULL) {
+		// Font covers all characters from First to Last
+		*index = character - font.First;
+	} else {
+		// Binary search in sorted codepoints
+		int32_t low = 0;
+		int32_t high = (int32_t)font.glyphCount - 1;
+
+		while (true) {
+			if (low > high) { return false; }
+
+			int32_t middle = (low + high) / 2; // 32 bit indices, counts above 32767 don't wrap
+			uint16_t current = pgm_read_word(&font.codepoints[middle]);
+			if (current == character) {
+				*index = middle;
+				break;
+			}
+
+			if (current < character) {
+				low = middle + 1;
+			} else {
+				high = middle - 1;
+			}
+		}
+	}
+
+	memcpy_P(glyph, &font.glyphs[*index], sizeof(sGLYPH));
+
+	return true;
+}
+
+int8_t ILI9486::getKerning(const sPFONT &font, uint16_t left, uint16_t right) {
+	if (font.kerning == NULL) { return 0; }
+
+	// Binary search, pairs are sorted by left then right glyph index
+	uint32_t key = ((uint32_t)left << 16) | right;
+	int32_t low = 0;
+	int32_t high = (int32_t)font.kerningCount - 1;
+
+	while (low <= high) {
+		int32_t middle = (low + high) / 2;
+		sKERNPAIR pair;
+		memcpy_P(&pair, &font.kerning[middle], sizeof(sKERNPAIR));
+
+		uint32_t current = ((uint32_t)pair.left << 16) | pair.right;
+		if (current == key) { return pair.adjust; }
+
+		if (current < key) {
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	return 0;
+}
+
+uint32_t ILI9486::decodeUTF8(const uint8_t **str, bool progmem) {
+	const uint8_t *s = *str;
+	uint8_t lead = readByte(s, progmem);
+	uint32_t codepoint;
+	uint8_t continuation; // Number of continuation bytes
+
+	if (lead < 0x80) {
+		codepoint = lead;
+		continuation = 0;
+	} else if ((lead & 0xE0) == 0xC0) {
+		codepoint = lead & 0x1F;
+		continuation = 1;
+	} else if ((lead & 0xF0) == 0xE0) {
+		codepoint = lead & 0x0F;
+		continuation = 2;
+	} else if ((lead & 0xF8) == 0xF0) {
+		codepoint = lead & 0x07;
+		continuation = 3;
+	} else {
+		*str = s + 1;
+		return 0xFFFD;
+	}
+
+	s++;
+	for (uint8_t i = 0; i < continuation; i++) {
+		uint8_t byte = readByte(s, progmem);
+
+		// Truncated sequence, also stops on string terminator
+		if ((byte & 0xC0) != 0x80) {
+			*str = s;
+			return 0xFFFD;
+		}
+
+		codepoint = (codepoint << 6) | (byte & 0x3F);
+		s++;
+	}
+
+	*str = s;
+	return codepoint;
+}
+
+uint8_t ILI9486::readByte(const uint8_t *p, bool progmem) {
+	return progmem ? pgm_read_byte(p) : *p;
+}
+
+const uint8_t *ILI9486::previousUTF8(const uint8_t *start, const uint8_t *p) {
+	// Skip continuation bytes back to lead byte
+	do {
+		p--;
+	} while (p > start && (*p & 0xC0) == 0x80);
+
+	return p;
+}
+
+uint8_t ILI9486::cellChar(uint32_t codepoint) {
+	// Fixed cell fonts contain only printable ASCII characters
+	return (codepoint < ' ' || codepoint > '~') ? '?' : codepoint;
+}
+
+const uint8_t *ILI9486::getGlyph(const sFONT *font, uint8_t character) {
+	character = cellChar(character);
+
+	// Some fonts have use more then 8 bits for one pixel line
+	uint8_t bytesPerLine = (font->Width + 7) / 8;
+
+	return font->table + (uint32_t)(character - ' ') * font->Height * bytesPerLine;
+}
+
+void ILI9486::blendTables(ILI9486_COLOR fg, uint8_t alpha, uint8_t *r, uint8_t *g, uint8_t *b) {
+	for (uint8_t i = 0; i < 64; i++) {
+		if (i < 32) {
+			r[i] = blend(fg, (uint16_t)i << 11, alpha) >> 11;
+			b[i] = blend(fg, i, alpha) & 0x1F;
+		}
+
+		g[i] = (blend(fg, (uint16_t)i << 5, alpha) >> 5) & 0x3F;
+	}
+}
+
+ILI9486_COLOR ILI9486::blendLookup(ILI9486_COLOR bg, const uint8_t *r, const uint8_t *g, const uint8_t *b) {
+	return ((uint16_t)r[bg >> 11] << 11) | ((uint16_t)g[(bg >> 5) & 0x3F] << 5) | b[bg & 0x1F];
+}
+
+void ILI9486::setWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+	// Ensure that coordinates are given in correct order
+	if (xStart > xEnd) {
+		uint16_t tmp = xStart;
+		xStart = xEnd;
+		xEnd = tmp;
+	}
+
+	if (yStart > yEnd) {
+		uint16_t tmp = yStart;
+		yStart = yEnd;
+		yEnd = tmp;
+	}
+
+	// Set the X coordinates
+	this->writeRegister(0x2A);
+	this->writeData(xStart >> 8); // Set the horizontal starting point to the high octet
+	this->writeData(xStart & 0xff);	// Set the horizontal starting point to the low octet
+	this->writeData((xEnd - 1) >> 8); // Set the horizontal end to the high octet
+	this->writeData((xEnd - 1) & 0xff); // Set the horizontal end to the low octet
+
+	// Set the Y coordinates
+	this->writeRegister(0x2B);
+	this->writeData(yStart >> 8);
+	this->writeData(yStart & 0xff );
+	this->writeData((yEnd - 1) >> 8);
+	this->writeData((yEnd - 1) & 0xff);
+}
+
+void ILI9486::beginRead(uint8_t reg) {
+	digitalWrite(this->DC, 0);
+	digitalWrite(this->CS, 0);
+	SPI.transfer(reg);
+	digitalWrite(this->DC, 1);
+
+	// First byte after read command is dummy
+	SPI.transfer(0x00);
+}
+
 void ILI9486::setOrientation(Orientation orientation) {
 	uint16_t MemoryAccessReg_Data = 0; //addr:0x36
 	uint16_t DisFunReg_Data = 0; //addr:0xB6
@@ -489,11 +1349,59 @@ void ILI9486::setOrientation(Orientation orientation) {
 		this->height = ILI9486_SHORT_SIDE;
 	}
 
+	// Viewport and clip stack start again with whole screen
+	this->clip.originX = 0;
+	this->clip.originY = 0;
+	this->clip.xStart = 0;
+	this->clip.yStart = 0;
+	this->clip.xEnd = this->width;
+	this->clip.yEnd = this->height;
+	this->clipDepth = 0;
+
 	// Set the read / write scan direction of the frame memory
 	this->writeRegister(0xB6);
 	this->writeData(0x00);
 	this->writeData(DisFunReg_Data);
 
+	this->memoryAccess = MemoryAccessReg_Data;
 	this->writeRegister(0x36);
 	this->writeData(MemoryAccessReg_Data);
 }
+
+bool ILI9486::pushClip(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd) {
+	if (this->clipDepth == ILI9486_CLIP_DEPTH) { return false; }
+
+	// Empty intersection is kept as empty rectangle, so nothing is drawn until popClip
+	this->clips[this->clipDepth++] = this->clip;
+	if (!this->clipRect(&xStart, &yStart, &xEnd, &yEnd)) {
+		xEnd = xStart;
+		yEnd = yStart;
+	}
+
+	this->clip.xStart = xStart;
+	this->clip.yStart = yStart;
+	this->clip.xEnd = xEnd;
+	this->clip.yEnd = yEnd;
+	return true;
+}
+
+bool ILI9486::pushViewport(int16_t x, int16_t y, uint16_t width, uint16_t height) {
+	if (!this->pushClip(x, y, x + width, y + height)) { return false; }
+
+	this->clip.originX += x;
+	this->clip.originY += y;
+	return true;
+}
+
+void ILI9486::popClip() {
+	if (this->clipDepth == 0) { return; }
+	this->clip = this->clips[--this->clipDepth];
+}
+
+int16_t ILI9486::getOriginX() {
+	return this->clip.originX;
+}
+
+int16_t ILI9486::getOriginY() {
+	return this->clip.originY;
+}
@@ -27,6 +27,8 @@ along with this program.  If not, see https://www.gnu.org/licenses/.
 #include <SD.h>
 
 #include "fonts/fonts.h"
+#include "fonts/aafont.h"
+#include "fonts/pfont.h"
 
 // Dimensions of LCD panel in pixels
 #define ILI9486_LONG_SIDE 480
@@ -40,6 +42,12 @@ along with this program.  If not, see https://www.gnu.org/licenses/.
 #define ILI9486_GREEN 0x0F00
 #define ILI9486_BLUE 0x00F0
 
+// Number of pixels buffered on stack when moving data between GRAM and SD card
+#define ILI9486_TRANSFER_CHUNK 32
+
+// Number of nested clip rectangles and viewports
+#define ILI9486_CLIP_DEPTH 4
+
 class ILI9486 {
 public:
 	// Order in which GRAM is scanned
@@ -54,6 +62,14 @@ public:
 		D2U_R2L
 	};
 
+	// Direction of text drawn with drawText, angle is measured from x axis towards y axis
+	enum Rotation {
+		ROTATE_0, // Text advances along increasing x
+		ROTATE_90, // Text advances along increasing y
+		ROTATE_180, // Text advances along decreasing x
+		ROTATE_270 // Text advances along decreasing y
+	};
+
 	// Possible font sizes
 	// Font size refers to single character height
 	enum FontSize {
@@ -64,12 +80,14 @@ public:
 		XL = 24
 	};
 	
-	ILI9486(uint8_t CS, uint8_t BL, uint8_t RST, uint8_t DC, Orientation orientation, uint8_t defaultBacklight, ILI9486_COLOR background = ILI9486_BLACK); // ILI9486 driver initialization, takes about 1 second to execute
+	ILI9486(uint8_t CS, uint8_t BL, uint8_t RST, uint8_t DC, Orientation orientation, uint8_t defaultBacklight, ILI9486_COLOR background = ILI9486_BLACK, bool clearScreen = true); // ILI9486 driver initialization, takes about 1 second to execute, without clearScreen GRAM keeps random content until application covers it
 
 	uint16_t getWidth(); // In pixels
 	uint16_t getHeight(); // In pixels
 	uint32_t getSize(); // Width times height [px]
 	uint16_t getDefaultBacklight();
+	uint16_t getCharWidth(FontSize size); // Width of character cell of standard font [px]
+	uint16_t getCharHeight(FontSize size); // Height of character cell of standard font [px]
 
 	void setBacklight(uint8_t value); // Set LCD backlight value, from 0(min) to 255(max)
 	void changeDefaultBacklight(uint8_t value); // Set LCD default backlight value, from 0(min) to 255(max), 255 after init
@@ -78,31 +96,115 @@ public:
 
 	void changeBackground(ILI9486_COLOR color); // Change default color to display on clear screen
 
-	void fill(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, ILI9486_COLOR color); // Fill area with given color
-	void clear(ILI9486_COLOR color); // Fill entire screen with given color
+	void fill(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color); // Fill area with given color
+	void clear(ILI9486_COLOR color); // Fill entire screen (clip rectangle when clipped) with given color
 	void clear(); // Fill entire screen with background color
 	void openWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd); // Set display area, do not use for drawing lines
 	void setCursor(uint16_t x, uint16_t y); // Set cursor to given position
 	
 	void writeColor(ILI9486_COLOR color, uint32_t n); // Write given colors n times
-	void writeBuffer(ILI9486_COLOR *buffer, uint32_t n); // Write buffer to screen
-	void setPixel(uint16_t x, uint16_t y, ILI9486_COLOR color); // Set cursor to given position and write color, slow due to setting cursor every pixel
-
-	void drawCircle(uint16_t x, uint16_t y, uint16_t radius, ILI9486_COLOR color, bool filled = false); // Draw circle with center at (x, y) using Bresenham's Circle Algorithm
-	void drawHLine(uint16_t x, uint16_t y, uint16_t len, ILI9486_COLOR color); // Draw horizontal line starting at point (x, y), incrementing x coordinate
-	void drawVLine(uint16_t x, uint16_t y, uint16_t len, ILI9486_COLOR color); // Draw vertical line starting at point (x, y), incrementing y coordinate
-	void drawLine(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, ILI9486_COLOR color); // Draw line from start to edn using Bresenham's Line Algorithm
+	void writeBuffer(const ILI9486_COLOR *buffer, uint32_t n); // Write buffer to screen
+	void writeBytes(const uint8_t *buffer, uint32_t n); // Write n colors stored most significant byte first, on Linux buffer is sent without copying and must stay unchanged until SPI.flush
+	void beginWrite(); // Select display for data write, colors are then sent with SPI.transfer16 (used by code producing pixels itself)
+	void endWrite(); // Deselect display after data write
+	void setPixel(int16_t x, int16_t y, ILI9486_COLOR color); // Set cursor to given position and write color, slow due to setting cursor every pixel
+
+	// Reading requires MISO pin to be connected
+	void openReadWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd); // Set area read by readBuffer
+	void readBuffer(ILI9486_COLOR *buffer, uint32_t n); // Read n colors from area, next call continues where previous one ended
+	ILI9486_COLOR getPixel(uint16_t x, uint16_t y); // Read single pixel color, slow due to setting area every pixel
+	void readRegister(uint8_t reg, uint8_t *buffer, uint8_t n); // Read n parameter bytes returned by register, dummy byte is skipped
+	uint32_t readID(); // Read display identification information (RDDID), 24 bits
+
+	// Save-under regions, buffer must hold (xEnd - xStart) * (yEnd - yStart) colors
+	void saveRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, ILI9486_COLOR *buffer); // Copy area from GRAM to buffer
+	void saveRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, ILI9486_COLOR *buffer, const ILI9486_COLOR *framebuffer); // Copy area from full screen shadow framebuffer to buffer
+	void saveRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, File &file); // Copy area from GRAM to file, starting at current file position
+	void restoreRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, const ILI9486_COLOR *buffer); // Write saved area back in one burst
+	void restoreRegion(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, File &file); // Write area saved in file back in one burst
+
+	void drawCircle(int16_t x, int16_t y, uint16_t radius, ILI9486_COLOR color, bool filled = false); // Draw circle with center at (x, y) using Bresenham's Circle Algorithm
+	void drawHLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color); // Draw horizontal line starting at point (x, y), incrementing x coordinate
+	void drawVLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color); // Draw vertical line starting at point (x, y), incrementing y coordinate
+	void drawLine(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color); // Draw line from start to edn using Bresenham's Line Algorithm
 	
-	void drawChar(uint16_t x, uint16_t y, uint8_t character, FontSize size, ILI9486_COLOR color); // Display character on the screen
-	void drawString(uint16_t x, uint16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color);
+	void drawChar(int16_t x, int16_t y, uint8_t character, FontSize size, ILI9486_COLOR color, uint8_t scale = 1); // Display character on the screen, every font pixel is drawn as scale x scale block
+	void drawString(int16_t x, int16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color, uint8_t scale = 1); // Strings are UTF-8 encoded, characters missing in font are drawn as '?'
+	void drawString(int16_t x, int16_t y, const __FlashStringHelper *str, FontSize size, ILI9486_COLOR color, uint8_t scale = 1); // String stored in FLASH memory with F() macro
+	void drawString_P(int16_t x, int16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color, uint8_t scale = 1); // String stored in FLASH memory with PROGMEM
+	void drawText(int16_t x, int16_t y, const uint8_t *str, uint16_t length, FontSize size, ILI9486_COLOR color, ILI9486_COLOR background, Rotation rotation = ROTATE_0); // Draw length bytes of str with background, whole line is written in one burst
+	void expandChar(uint8_t character, FontSize size, ILI9486_COLOR color, ILI9486_COLOR background, ILI9486_COLOR *cell); // Write pixels of character cell to buffer of getCharWidth * getCharHeight pixels, in order used by drawCell
+	void drawCell(int16_t x, int16_t y, FontSize size, const ILI9486_COLOR *cell); // Write expanded character cell centered at (x, y) in one burst
+
+	// Anti-aliased text, edges of characters are blended with background color, whole character cell is written in one burst
+	void drawChar(int16_t x, int16_t y, uint8_t character, const sAAFONT &font, ILI9486_COLOR color, ILI9486_COLOR background);
+	void drawString(int16_t x, int16_t y, const uint8_t *str, const sAAFONT &font, ILI9486_COLOR color, ILI9486_COLOR background);
+	void drawString(int16_t x, int16_t y, const __FlashStringHelper *str, const sAAFONT &font, ILI9486_COLOR color, ILI9486_COLOR background);
+
+	// Proportional text, (x, y) is left end of text and vertical center of line, only inked box of every character is written
+	void drawChar(int16_t x, int16_t y, uint32_t character, const sPFONT &font, ILI9486_COLOR color, ILI9486_COLOR background);
+	void drawString(int16_t x, int16_t y, const uint8_t *str, const sPFONT &font, ILI9486_COLOR color, ILI9486_COLOR background); // Uses kerning if font has it
+	void drawString(int16_t x, int16_t y, const __FlashStringHelper *str, const sPFONT &font, ILI9486_COLOR color, ILI9486_COLOR background);
+
+	// Alpha blending, alpha from 0 (transparent) to 255 (opaque)
+	// Colors are blended with known background color or with full screen shadow framebuffer (getWidth() x getHeight() colors), which is updated with blended colors (FB suffix keeps 0 background apart from framebuffer pointer)
+	void fill(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR background);
+	void fillFB(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR *framebuffer);
+	void drawHLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR background);
+	void drawHLineFB(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR *framebuffer);
+	void drawChar(int16_t x, int16_t y, uint8_t character, FontSize size, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR background); // Whole character cell is written in one burst
+	void drawCharFB(int16_t x, int16_t y, uint8_t character, FontSize size, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR *framebuffer);
+	void drawString(int16_t x, int16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR background);
+	void drawStringFB(int16_t x, int16_t y, const uint8_t *str, FontSize size, ILI9486_COLOR color, uint8_t alpha, ILI9486_COLOR *framebuffer);
+
+	static uint32_t decodeUTF8(const uint8_t **str, bool progmem = false); // Decode one character and move str past it, invalid sequences give U+FFFD
+	static uint8_t cellChar(uint32_t codepoint); // Character of fixed cell font used for codepoint, '?' if font has no such character
+
+	static ILI9486_COLOR blend(ILI9486_COLOR fg, ILI9486_COLOR bg, uint8_t alpha); // Blend two colors, alpha refers to fg
+	static void blendRamp(ILI9486_COLOR fg, ILI9486_COLOR bg, ILI9486_COLOR *ramp, uint8_t levels); // Fill ramp with levels colors going from bg (ramp[0]) to fg (ramp[levels - 1])
 
 	void setOrientation(Orientation orientation); // Set order in which GRAM is scanned
 
+	// Viewport and clipping, drawing methods take signed coordinates relative to origin and draw only inside clip rectangle,
+	// which is applied to whole rectangles and spans before any window is opened
+	// Low level methods (openWindow, writeColor, writeBuffer, reading, save-under regions) use screen coordinates and are not clipped
+	bool pushClip(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd); // Intersect clip rectangle with given one, returns false when stack is full
+	bool pushViewport(int16_t x, int16_t y, uint16_t width, uint16_t height); // Move origin to (x, y) and intersect clip rectangle with width x height area there
+	void popClip(); // Restore origin and clip rectangle from before last push
+	int16_t getOriginX(); // Origin in screen coordinates
+	int16_t getOriginY();
+
 private:
 	void reset(); // Hardware reset, takes about 300ms to complete
 	void initializeRegisters(); // Write inital values to registers
 	void writeRegister(uint8_t reg); // Write register address  
 	void writeData(uint8_t data); // Write data to register
+	void setWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd); // Set column and page address without starting memory write
+	void beginRead(uint8_t reg); // Send register address and leave CS low for following reads
+
+	// Strings are read from FLASH memory if progmem is true
+	void drawStringFrom(int16_t x, int16_t y, const uint8_t *str, bool progmem, FontSize size, ILI9486_COLOR color, uint8_t scale);
+	void drawStringFrom(int16_t x, int16_t y, const uint8_t *str, bool progmem, const sAAFONT &font, ILI9486_COLOR color, ILI9486_COLOR background);
+	void drawStringFrom(int16_t x, int16_t y, const uint8_t *str, bool progmem, const sPFONT &font, ILI9486_COLOR color, ILI9486_COLOR background);
+	static uint8_t readByte(const uint8_t *p, bool progmem);
+	static const uint8_t *previousUTF8(const uint8_t *start, const uint8_t *p); // First byte of character which ends at p
+
+	const sFONT *getFont(FontSize size); // Font table for given size
+	bool openCharWindow(uint16_t width, uint16_t height, int16_t x, int16_t y); // Open clipped window covering character cell centered at (x, y), false when cell is not visible
+	bool clipRect(int16_t *xStart, int16_t *yStart, int16_t *xEnd, int16_t *yEnd); // Move rectangle relative to origin to screen and clip it, false when nothing is left
+	bool openClippedWindow(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, bool transposed = false); // Open window of visible part of rectangle and filter pixels written in order of whole rectangle with writePixel, false when nothing is visible
+	void writePixel(ILI9486_COLOR color); // Write next pixel of clipped window, pixels outside clip are skipped
+	void drawGlyph(int16_t x, int16_t y, uint8_t character, const sAAFONT &font, const ILI9486_COLOR *ramp); // Stream anti-aliased character using color for every coverage value
+	void drawGlyph(int16_t x, int16_t y, const sGLYPH &glyph, const sPFONT &font, const ILI9486_COLOR *ramp); // Stream inked box of proportional character, x is pen position
+	void writeRLE(const uint8_t *bitmap, uint16_t n, uint8_t bpp, const ILI9486_COLOR *ramp); // Decode run-length encoded bitmap and write n colors
+	bool getGlyph(const sPFONT &font, uint32_t character, sGLYPH *glyph, uint16_t *index); // Copy glyph from FLASH memory, false if font has no such character
+	int8_t getKerning(const sPFONT &font, uint16_t left, uint16_t right); // Distance correction between two glyphs
+	const uint8_t *getGlyph(const sFONT *font, uint8_t character); // Address of character bitmap in FLASH memory
+
+
+	// Blend tables map every possible bg channel value to channel blended with fg, 32 red, 64 green and 32 blue entries
+	static void blendTables(ILI9486_COLOR fg, uint8_t alpha, uint8_t *r, uint8_t *g, uint8_t *b);
+	static ILI9486_COLOR blendLookup(ILI9486_COLOR bg, const uint8_t *r, const uint8_t *g, const uint8_t *b);
 
 	// Arduino pin numbers
 	uint8_t CS;
@@ -114,4 +216,30 @@ private:
 	uint16_t width; // [px]
 	uint16_t height; // [px]
 	ILI9486_COLOR background; // Default color to display on clear screen
+	bool readStarted; // Whether memory read was issued since last openReadWindow
+	uint8_t memoryAccess; // MADCTL register value set by setOrientation
+
+	// Origin and clip rectangle in screen coordinates, exclusive end
+	struct Clip {
+		int16_t originX;
+		int16_t originY;
+		int16_t xStart;
+		int16_t yStart;
+		int16_t xEnd;
+		int16_t yEnd;
+	};
+
+	Clip clip;
+	Clip clips[ILI9486_CLIP_DEPTH]; // Saved by push methods
+	uint8_t clipDepth;
+
+	// Pixels of partly visible window opened by openClippedWindow, coordinates are relative to requested window
+	bool clipping; // Whether writePixel skips pixels
+	uint16_t clipWidth; // Width of requested window
+	uint16_t clipColumn; // Position of next pixel
+	uint16_t clipRow;
+	uint16_t visibleLeft; // Visible part, exclusive end
+	uint16_t visibleRight;
+	uint16_t visibleTop;
+	uint16_t visibleBottom;
 };
@@ -0,0 +1,188 @@
+/*
+ILI9486Animation.cpp
+Implementation of ILI9486Animation class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486Animation.h"
+
+ILI9486Animation::ILI9486Animation(ILI9486 *display, const uint8_t *data, bool progmem):
+	display(display),
+	data(data),
+	position(data),
+	progmem(progmem),
+	file(NULL),
+	start(0)
+{
+	this->readHeader();
+}
+
+ILI9486Animation::ILI9486Animation(ILI9486 *display, File &file):
+	display(display),
+	data(NULL),
+	position(NULL),
+	progmem(false),
+	file(&file),
+	start(file.position())
+{
+	this->readHeader();
+}
+
+bool ILI9486Animation::isValid() {
+	return this->valid;
+}
+
+uint16_t ILI9486Animation::getWidth() {
+	return this->width;
+}
+
+uint16_t ILI9486Animation::getHeight() {
+	return this->height;
+}
+
+uint16_t ILI9486Animation::getFrames() {
+	return this->frames;
+}
+
+uint16_t ILI9486Animation::getFrameTime() {
+	return this->frameTime;
+}
+
+bool ILI9486Animation::drawFrame(uint16_t x, uint16_t y) {
+	if (!this->valid || this->frame >= this->frames) { return false; }
+
+	ILI9486_COLOR colors[ILI9486_TRANSFER_CHUNK];
+	uint16_t rectangles = this->readWord();
+	this->framePixels = 0;
+
+	for (uint16_t r = 0; r < rectangles; r++) {
+		uint16_t left = x + this->readWord();
+		uint16_t top = y + this->readWord();
+		uint16_t width = this->readWord();
+		uint16_t height = this->readWord();
+		uint32_t n = (uint32_t)width * height;
+
+		// Window is opened once, runs continue where previous one ended
+		this->display->openWindow(left, top, left + width, top + height);
+
+		for (uint32_t i = 0; i < n;) {
+			uint8_t run = this->readByte();
+			uint8_t length = (run & ~ILI9486_ANIMATION_REPEAT) + 1;
+
+			if (run & ILI9486_ANIMATION_REPEAT) {
+				this->display->writeColor(this->readWord(), length);
+			} else {
+				for (uint8_t j = 0; j < length; j += ILI9486_TRANSFER_CHUNK) {
+					uint8_t chunk = (length - j < ILI9486_TRANSFER_CHUNK) ? (length - j) : ILI9486_TRANSFER_CHUNK;
+					this->readColors(colors, chunk);
+					this->display->writeBuffer(colors, chunk);
+				}
+			}
+
+			i += length;
+		}
+
+		this->framePixels += n;
+	}
+
+	this->frame++;
+	return true;
+}
+
+bool ILI9486Animation::update(uint16_t x, uint16_t y, bool loop) {
+	if (!this->valid) { return false; }
+
+	unsigned long now = millis();
+	if (this->started && (long)(now - this->due) < 0) { return false; }
+
+	if (this->frame >= this->frames) {
+		if (!loop) { return false; }
+		this->rewind();
+	}
+
+	this->drawFrame(x, y);
+
+	// Frames can't be skipped, late frame moves schedule of following ones
+	if (this->started && (long)(now - this->due) < (long)this->frameTime) {
+		this->due += this->frameTime;
+	} else {
+		this->due = now + this->frameTime;
+	}
+
+	this->started = true;
+	return true;
+}
+
+void ILI9486Animation::rewind() {
+	if (this->file != NULL) {
+		this->file->seek(this->start + ILI9486_ANIMATION_HEADER);
+	} else {
+		this->position = this->data + ILI9486_ANIMATION_HEADER;
+	}
+
+	this->frame = 0;
+}
+
+uint16_t ILI9486Animation::getFrame() {
+	return this->frame;
+}
+
+uint32_t ILI9486Animation::getFramePixels() {
+	return this->framePixels;
+}
+
+void ILI9486Animation::readHeader() {
+	this->valid = true;
+	for (uint8_t i = 0; i < 4; i++) {
+		this->valid = this->readByte() == (uint8_t)ILI9486_ANIMATION_MAGIC[i] && this->valid;
+	}
+
+	this->width = this->readWord();
+	this->height = this->readWord();
+	this->frames = this->readWord();
+	this->frameTime = this->readWord();
+
+	this->frame = 0;
+	this->framePixels = 0;
+	this->due = 0;
+	this->started = false;
+}
+
+uint8_t ILI9486Animation::readByte() {
+	if (this->file != NULL) {
+		return this->file->read();
+	}
+
+	uint8_t value = this->progmem ? pgm_read_byte(this->position) : *this->position;
+	this->position++;
+	return value;
+}
+
+uint16_t ILI9486Animation::readWord() {
+	uint16_t low = this->readByte();
+	return low | ((uint16_t)this->readByte() << 8);
+}
+
+void ILI9486Animation::readColors(ILI9486_COLOR *colors, uint8_t n) {
+	// Colors are little endian, like in memory of supported boards
+	if (this->file != NULL) {
+		this->file->read((uint8_t*)colors, n * sizeof(ILI9486_COLOR));
+		return;
+	}
+
+	for (uint8_t i = 0; i < n; i++) {
+		colors[i] = this->readWord();
+	}
+}
@@ -0,0 +1,82 @@
+/*
+ILI9486Animation.h
+Class ILI9486Animation plays delta-frame animations, where every frame is a list
+of changed rectangles with run-length encoded pixels. Animations are read from
+RAM, FLASH (PROGMEM) or file.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Format (numbers are little endian):
+header:    "IDLT", uint16_t width, uint16_t height, uint16_t frames, uint16_t frameTime [ms]
+frame:     uint16_t rectangles, then rectangles
+rectangle: uint16_t x, y, width, height (relative to animation origin), then runs covering width * height pixels
+run:       byte n < 0x80 followed by n + 1 colors (literal), or byte n >= 0x80 followed by one color repeated (n & 0x7F) + 1 times
+First frame covers whole animation area, following ones only areas changed since previous frame.
+*/
+
+#pragma once
+
+#include "ILI9486.h"
+
+#define ILI9486_ANIMATION_MAGIC "IDLT"
+#define ILI9486_ANIMATION_HEADER 12 // Size of header in bytes
+
+// Run length limit and flag of repeated runs
+#define ILI9486_ANIMATION_RUN 128
+#define ILI9486_ANIMATION_REPEAT 0x80
+
+class ILI9486Animation {
+public:
+	ILI9486Animation(ILI9486 *display, const uint8_t *data, bool progmem = false); // Animation in RAM or in FLASH memory
+	ILI9486Animation(ILI9486 *display, File &file); // Animation read from file, starting at current file position
+
+	bool isValid(); // Whether header was recognized
+	uint16_t getWidth();
+	uint16_t getHeight();
+	uint16_t getFrames();
+	uint16_t getFrameTime(); // Time between frames [ms]
+
+	bool drawFrame(uint16_t x, uint16_t y); // Draw next frame with upper left corner at (x, y), returns false when all frames were drawn
+	bool update(uint16_t x, uint16_t y, bool loop = true); // Draw next frame if its time has come (for use in loop()), returns whether frame was drawn
+	void rewind(); // Next frame is first one, which redraws whole area
+
+	uint16_t getFrame(); // Number of next frame
+	uint32_t getFramePixels(); // Number of pixels written by last frame
+
+private:
+	void readHeader();
+	uint8_t readByte();
+	uint16_t readWord();
+	void readColors(ILI9486_COLOR *colors, uint8_t n);
+
+	ILI9486 *display;
+	const uint8_t *data; // Start of animation in memory, NULL for file
+	const uint8_t *position;
+	bool progmem;
+	File *file;
+	uint32_t start; // File position of header
+
+	bool valid;
+	uint16_t width;
+	uint16_t height;
+	uint16_t frames;
+	uint16_t frameTime;
+
+	uint16_t frame;
+	uint32_t framePixels;
+	unsigned long due; // Time of next frame [ms]
+	bool started; // First frame was drawn by update
+};
@@ -0,0 +1,428 @@
+/*
+ILI9486Converter.cpp
+Implementation of ILI9486Converter class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486Converter.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define ILI9486_CONVERTER_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#define ILI9486_CONVERTER_NEON
+#include <arm_neon.h>
+#endif
+
+// 4x4 Bayer matrix, values 0 - 15
+static const uint8_t bayer[4][4] = {
+	{0, 8, 2, 10},
+	{12, 4, 14, 6},
+	{3, 11, 1, 9},
+	{15, 7, 13, 5}
+};
+
+// Thresholds added before truncation, 5 bit components step by 8 and 6 bit ones by 4
+#define ILI9486_DITHER_5(value) ((value) >> 1)
+#define ILI9486_DITHER_6(value) ((value) >> 2)
+
+static inline uint8_t addSaturated(uint8_t a, uint8_t b) {
+	uint16_t sum = a + b;
+	return sum > 255 ? 255 : sum;
+}
+
+static inline void storeColor(uint8_t *destination, uint16_t color, bool swap) {
+	if (swap) {
+		destination[0] = color >> 8;
+		destination[1] = color;
+	} else {
+		memcpy(destination, &color, 2);
+	}
+}
+
+// Converts n pixels, thresholds is row of Bayer matrix or NULL, phase is column of first pixel
+static void convertScalar(const uint8_t *source, uint8_t *destination, uint16_t n, ILI9486Converter::Format format, const uint8_t *thresholds, uint8_t phase, bool swap) {
+	uint8_t step = format == ILI9486Converter::RGB888 ? 3 : 4;
+
+	for (uint16_t i = 0; i < n; i++) {
+		uint8_t r, g, b;
+		if (format == ILI9486Converter::RGB888) {
+			r = source[0];
+			g = source[1];
+			b = source[2];
+		} else {
+			b = source[0];
+			g = source[1];
+			r = source[2];
+		}
+
+		if (thresholds != NULL) {
+			uint8_t threshold = thresholds[(phase + i) & 3];
+			r = addSaturated(r, ILI9486_DITHER_5(threshold));
+			g = addSaturated(g, ILI9486_DITHER_6(threshold));
+			b = addSaturated(b, ILI9486_DITHER_5(threshold));
+		}
+
+		storeColor(destination, ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3), swap);
+		source += step;
+		destination += 2;
+	}
+}
+
+#ifdef ILI9486_CONVERTER_X86
+
+// Pattern added to 4 pixels in B, G, R, X byte order, starting at given phase
+static inline __m128i ditherPattern(const uint8_t *thresholds, uint8_t phase) {
+	uint8_t pattern[16];
+	for (uint8_t i = 0; i < 4; i++) {
+		uint8_t threshold = thresholds != NULL ? thresholds[(phase + i) & 3] : 0;
+		pattern[i * 4] = ILI9486_DITHER_5(threshold);
+		pattern[i * 4 + 1] = ILI9486_DITHER_6(threshold);
+		pattern[i * 4 + 2] = ILI9486_DITHER_5(threshold);
+		pattern[i * 4 + 3] = 0;
+	}
+	return _mm_loadu_si128((const __m128i*)pattern);
+}
+
+// Packs 4 pixels in B, G, R, X byte order into RGB565 in low halves of 32 bit lanes
+static inline __m128i pack565(__m128i pixels) {
+	__m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 8), _mm_set1_epi32(0xF800));
+	__m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 5), _mm_set1_epi32(0x07E0));
+	__m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 3), _mm_set1_epi32(0x001F));
+	__m128i color = _mm_or_si128(_mm_or_si128(r, g), b);
+
+	// Sign extension makes signed saturation of packing keep all 16 bits
+	return _mm_srai_epi32(_mm_slli_epi32(color, 16), 16);
+}
+
+static inline __m128i swapBytes(__m128i colors) {
+	return _mm_or_si128(_mm_slli_epi16(colors, 8), _mm_srli_epi16(colors, 8));
+}
+
+static uint16_t convertSSE2(const uint8_t *source, uint8_t *destination, uint16_t n, const uint8_t *thresholds, uint8_t phase, bool swap) {
+	__m128i pattern = ditherPattern(thresholds, phase);
+	uint16_t i = 0;
+
+	for (; i + 8 <= n; i += 8) {
+		__m128i low = _mm_adds_epu8(_mm_loadu_si128((const __m128i*)(source + i * 4)), pattern);
+		__m128i high = _mm_adds_epu8(_mm_loadu_si128((const __m128i*)(source + i * 4 + 16)), pattern);
+		__m128i colors = _mm_packs_epi32(pack565(low), pack565(high));
+		if (swap) {
+			colors = swapBytes(colors);
+		}
+		_mm_storeu_si128((__m128i*)(destination + i * 2), colors);
+	}
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static uint16_t convertSSSE3(const uint8_t *source, uint8_t *destination, uint16_t n, const uint8_t *thresholds, uint8_t phase, bool swap) {
+	// Spreads 4 pixels of R, G, B bytes into B, G, R, X lanes
+	const __m128i spread = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+	__m128i pattern = ditherPattern(thresholds, phase);
+	uint16_t i = 0;
+
+	// Every load reads 16 bytes but uses 12, last 4 bytes must stay inside source
+	for (; i + 10 <= n; i += 8) {
+		__m128i low = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(source + i * 3)), spread);
+		__m128i high = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(source + i * 3 + 12)), spread);
+		low = _mm_adds_epu8(low, pattern);
+		high = _mm_adds_epu8(high, pattern);
+		__m128i colors = _mm_packs_epi32(pack565(low), pack565(high));
+		if (swap) {
+			colors = _mm_shuffle_epi8(colors, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+		}
+		_mm_storeu_si128((__m128i*)(destination + i * 2), colors);
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static uint16_t convertAVX2(const uint8_t *source, uint8_t *destination, uint16_t n, const uint8_t *thresholds, uint8_t phase, bool swap) {
+	__m128i half = ditherPattern(thresholds, phase);
+	__m256i pattern = _mm256_broadcastsi128_si256(half);
+	const __m256i swapping = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	uint16_t i = 0;
+
+	for (; i + 16 <= n; i += 16) {
+		__m256i pixels[2];
+		for (uint8_t j = 0; j < 2; j++) {
+			__m256i p = _mm256_adds_epu8(_mm256_loadu_si256((const __m256i*)(source + i * 4 + j * 32)), pattern);
+			__m256i r = _mm256_and_si256(_mm256_srli_epi32(p, 8), _mm256_set1_epi32(0xF800));
+			__m256i g = _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x07E0));
+			__m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 3), _mm256_set1_epi32(0x001F));
+			__m256i color = _mm256_or_si256(_mm256_or_si256(r, g), b);
+			pixels[j] = _mm256_srai_epi32(_mm256_slli_epi32(color, 16), 16);
+		}
+
+		// Packing works within 128 bit halves, permutation restores pixel order
+		__m256i colors = _mm256_permute4x64_epi64(_mm256_packs_epi32(pixels[0], pixels[1]), 0xD8);
+		if (swap) {
+			colors = _mm256_shuffle_epi8(colors, swapping);
+		}
+		_mm256_storeu_si256((__m256i*)(destination + i * 2), colors);
+	}
+
+	return i;
+}
+
+#endif
+
+#ifdef ILI9486_CONVERTER_NEON
+
+static inline uint8x8_t ditherHalf(const uint8_t *thresholds, uint8_t phase, bool six) {
+	uint8_t pattern[8];
+	for (uint8_t i = 0; i < 8; i++) {
+		uint8_t threshold = thresholds != NULL ? thresholds[(phase + i) & 3] : 0;
+		pattern[i] = six ? ILI9486_DITHER_6(threshold) : ILI9486_DITHER_5(threshold);
+	}
+	return vld1_u8(pattern);
+}
+
+static inline void store565(uint8_t *destination, uint8x8_t r, uint8x8_t g, uint8x8_t b, bool swap) {
+	// Insertions keep top bits of previous components
+	uint16x8_t color = vshll_n_u8(r, 8);
+	color = vsriq_n_u16(color, vshll_n_u8(g, 8), 5);
+	color = vsriq_n_u16(color, vshll_n_u8(b, 8), 11);
+
+	uint8x16_t bytes = vreinterpretq_u8_u16(color);
+	if (swap) {
+		bytes = vrev16q_u8(bytes);
+	}
+	vst1q_u8(destination, bytes);
+}
+
+static uint16_t convertNEON(const uint8_t *source, uint8_t *destination, uint16_t n, ILI9486Converter::Format format, const uint8_t *thresholds, uint8_t phase, bool swap) {
+	uint8x8_t pattern5 = ditherHalf(thresholds, phase, false);
+	uint8x8_t pattern6 = ditherHalf(thresholds, phase, true);
+	uint16_t i = 0;
+
+	for (; i + 8 <= n; i += 8) {
+		uint8x8_t r, g, b;
+		if (format == ILI9486Converter::RGB888) {
+			uint8x8x3_t pixels = vld3_u8(source + i * 3);
+			r = pixels.val[0];
+			g = pixels.val[1];
+			b = pixels.val[2];
+		} else {
+			uint8x8x4_t pixels = vld4_u8(source + i * 4);
+			b = pixels.val[0];
+			g = pixels.val[1];
+			r = pixels.val[2];
+		}
+
+		store565(destination + i * 2, vqadd_u8(r, pattern5), vqadd_u8(g, pattern6), vqadd_u8(b, pattern5), swap);
+	}
+
+	return i;
+}
+
+#endif
+
+ILI9486Converter::ILI9486Converter(Format format, Dither dither, uint16_t width):
+	format(format),
+	dither(dither),
+	kernel(getBestKernel()),
+	width(width),
+	errors(NULL),
+	row(-1)
+{
+	if (dither == DIFFUSION_DITHER) {
+		// Two rows with one pixel of margin on both sides
+		this->errors = (int16_t*)calloc(2 * 3 * (width + 2), sizeof(int16_t));
+	}
+}
+
+ILI9486Converter::~ILI9486Converter() {
+	free(this->errors);
+}
+
+void ILI9486Converter::convert(const uint8_t *source, ILI9486_COLOR *destination, uint16_t n, uint16_t x, uint16_t y) {
+	this->convertRow(source, (uint8_t*)destination, n, x, y, false);
+}
+
+void ILI9486Converter::convertForTransfer(const uint8_t *source, uint8_t *destination, uint16_t n, uint16_t x, uint16_t y) {
+	this->convertRow(source, destination, n, x, y, true);
+}
+
+void ILI9486Converter::write(ILI9486 *display, const uint8_t *source, uint16_t n, uint16_t x, uint16_t y) {
+	uint8_t step = this->format == RGB888 ? 3 : 4;
+
+	display->beginWrite();
+
+#ifdef ILI9486_SPI_STAGING
+	// Colors are converted directly into SPI queue, most significant byte first
+	uint32_t limit = SPI.getMessageSize() / 2;
+
+	while (n > 0) {
+		uint16_t chunk = n < limit ? n : limit;
+		this->convertRow(source, SPI.reserve(chunk * 2), chunk, x, y, true);
+		source += chunk * step;
+		x += chunk;
+		n -= chunk;
+	}
+#else
+	ILI9486_COLOR colors[ILI9486_TRANSFER_CHUNK];
+
+	while (n > 0) {
+		uint16_t chunk = n < ILI9486_TRANSFER_CHUNK ? n : ILI9486_TRANSFER_CHUNK;
+		this->convertRow(source, (uint8_t*)colors, chunk, x, y, false);
+
+		for (uint16_t i = 0; i < chunk; i++) {
+			SPI.transfer16(colors[i]);
+		}
+
+		source += chunk * step;
+		x += chunk;
+		n -= chunk;
+	}
+#endif
+
+	display->endWrite();
+}
+
+void ILI9486Converter::setKernel(Kernel kernel) {
+	this->kernel = isSupported(kernel) ? kernel : SCALAR;
+}
+
+ILI9486Converter::Kernel ILI9486Converter::getKernel() {
+	return this->kernel;
+}
+
+ILI9486Converter::Kernel ILI9486Converter::getBestKernel() {
+	if (isSupported(AVX2)) { return AVX2; }
+	if (isSupported(SSSE3)) { return SSSE3; }
+	if (isSupported(SSE2)) { return SSE2; }
+	if (isSupported(NEON)) { return NEON; }
+	return SCALAR;
+}
+
+bool ILI9486Converter::isSupported(Kernel kernel) {
+	switch (kernel) {
+		case SCALAR: return true;
+#ifdef ILI9486_CONVERTER_X86
+		case SSE2: return true;
+		case SSSE3: return __builtin_cpu_supports("ssse3");
+		case AVX2: return __builtin_cpu_supports("avx2");
+#endif
+#ifdef ILI9486_CONVERTER_NEON
+		case NEON: return true;
+#endif
+		default: return false;
+	}
+}
+
+const char *ILI9486Converter::getKernelName(Kernel kernel) {
+	switch (kernel) {
+		case SSE2: return "SSE2";
+		case SSSE3: return "SSSE3";
+		case AVX2: return "AVX2";
+		case NEON: return "NEON";
+		default: return "scalar";
+	}
+}
+
+void ILI9486Converter::convertRow(const uint8_t *source, uint8_t *destination, uint16_t n, uint16_t x, uint16_t y, bool swap) {
+	if (this->dither == DIFFUSION_DITHER) {
+		this->diffuse(source, destination, n, x, y, swap);
+		return;
+	}
+
+	const uint8_t *thresholds = this->dither == ORDERED_DITHER ? bayer[y & 3] : NULL;
+	uint16_t done = 0;
+
+	// Vector kernels convert multiples of their width, scalar one converts the rest
+#ifdef ILI9486_CONVERTER_X86
+	if (this->format == XRGB8888 && this->kernel == AVX2) {
+		done = convertAVX2(source, destination, n, thresholds, x & 3, swap);
+	} else if (this->format == XRGB8888 && this->kernel != SCALAR) {
+		done = convertSSE2(source, destination, n, thresholds, x & 3, swap);
+	} else if (this->format == RGB888 && (this->kernel == SSSE3 || this->kernel == AVX2)) {
+		done = convertSSSE3(source, destination, n, thresholds, x & 3, swap);
+	}
+#endif
+#ifdef ILI9486_CONVERTER_NEON
+	if (this->kernel == NEON) {
+		done = convertNEON(source, destination, n, this->format, thresholds, x & 3, swap);
+	}
+#endif
+
+	uint8_t step = this->format == RGB888 ? 3 : 4;
+	convertScalar(source + done * step, destination + done * 2, n - done, this->format, thresholds, (x + done) & 3, swap);
+}
+
+void ILI9486Converter::diffuse(const uint8_t *source, uint8_t *destination, uint16_t n, uint16_t x, uint16_t y, bool swap) {
+	uint16_t stride = 3 * (this->width + 2);
+
+	if (this->row != y) {
+		// Errors of next row become current ones, first row or jump starts without errors
+		if (this->row >= 0 && y == this->row + 1) {
+			memcpy(this->errors, this->errors + stride, stride * sizeof(int16_t));
+		} else {
+			memset(this->errors, 0, stride * sizeof(int16_t));
+		}
+		memset(this->errors + stride, 0, stride * sizeof(int16_t));
+		this->row = y;
+	}
+
+	// Pixels right of converter width have no error storage, they are converted without dithering, so every
+	// requested color is written (destination may be reserved SPI queue)
+	uint8_t step = this->format == RGB888 ? 3 : 4;
+	uint16_t diffused = n;
+	if ((uint32_t)x + n > this->width) {
+		diffused = x >= this->width ? 0 : this->width - x;
+		convertScalar(source + diffused * step, destination + diffused * 2, n - diffused, this->format, NULL, 0, swap);
+	}
+
+	for (uint16_t i = 0; i < diffused; i++) {
+		// Errors of pixel at column c are stored at c + 1
+		int16_t *current = this->errors + 3 * (x + i + 1);
+		int16_t *next = current + stride;
+		uint8_t rgb[3];
+
+		if (this->format == RGB888) {
+			rgb[0] = source[0];
+			rgb[1] = source[1];
+			rgb[2] = source[2];
+		} else {
+			rgb[0] = source[2];
+			rgb[1] = source[1];
+			rgb[2] = source[0];
+		}
+
+		for (uint8_t c = 0; c < 3; c++) {
+			int16_t value = rgb[c] + current[c] / 16;
+			value = value < 0 ? 0 : (value > 255 ? 255 : value);
+
+			// Green has 6 bits, red and blue 5
+			rgb[c] = value & (c == 1 ? 0xFC : 0xF8);
+			int16_t error = value - rgb[c];
+
+			current[c + 3] += error * 7;
+			next[c - 3] += error * 3;
+			next[c] += error * 5;
+			next[c + 3] += error;
+		}
+
+		storeColor(destination, (rgb[0] << 8) | (rgb[1] << 3) | (rgb[2] >> 3), swap);
+		source += step;
+		destination += 2;
+	}
+}
@@ -0,0 +1,71 @@
+/*
+ILI9486Converter.h
+Class ILI9486Converter converts rows of 24 and 32 bit images to display colors,
+optionally with dithering. SIMD kernels are used where available.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "ILI9486.h"
+
+class ILI9486Converter {
+public:
+	enum Format {
+		RGB888, // Bytes R, G, B
+		XRGB8888 // 32 bit little endian words 0xXXRRGGBB, bytes B, G, R, X
+	};
+
+	enum Dither {
+		NO_DITHER, // Lower bits are dropped
+		ORDERED_DITHER, // 4x4 Bayer matrix, rows can be converted in any order
+		DIFFUSION_DITHER // Floyd-Steinberg, rows must be converted from top to bottom, always uses scalar kernel
+	};
+
+	// Instruction set used for conversion
+	enum Kernel {
+		SCALAR,
+		SSE2, // XRGB8888 only, RGB888 uses scalar kernel
+		SSSE3,
+		AVX2, // XRGB8888 only, RGB888 uses SSSE3 kernel
+		NEON
+	};
+
+	// Width is the widest row which will be converted, it sizes error buffers of diffusion dither
+	ILI9486Converter(Format format, Dither dither = NO_DITHER, uint16_t width = ILI9486_LONG_SIDE);
+	~ILI9486Converter();
+
+	void convert(const uint8_t *source, ILI9486_COLOR *destination, uint16_t n, uint16_t x = 0, uint16_t y = 0); // Convert n pixels of row, (x, y) is position of first pixel, used by dithering
+	void convertForTransfer(const uint8_t *source, uint8_t *destination, uint16_t n, uint16_t x = 0, uint16_t y = 0); // Convert n pixels to bytes in SPI order, most significant byte first
+	void write(ILI9486 *display, const uint8_t *source, uint16_t n, uint16_t x = 0, uint16_t y = 0); // Convert n pixels and write them to open window
+
+	void setKernel(Kernel kernel); // Select kernel, unsupported kernel selects scalar one
+	Kernel getKernel();
+	static Kernel getBestKernel(); // Fastest kernel supported by compiler and processor
+	static bool isSupported(Kernel kernel);
+	static const char *getKernelName(Kernel kernel);
+
+private:
+	void convertRow(const uint8_t *source, uint8_t *destination, uint16_t n, uint16_t x, uint16_t y, bool swap); // Swapped colors have most significant byte first, like on SPI
+	void diffuse(const uint8_t *source, uint8_t *destination, uint16_t n, uint16_t x, uint16_t y, bool swap);
+
+	Format format;
+	Dither dither;
+	Kernel kernel;
+	uint16_t width;
+
+	int16_t *errors; // Diffusion errors of current and next row, 3 components per pixel, scaled by 16
+	int32_t row; // Row which errors belong to, -1 before first row
+};
@@ -0,0 +1,325 @@
+/*
+ILI9486DisplayList.cpp
+Implementation of ILI9486DisplayList class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486DisplayList.h"
+
+static int16_t clampCoordinate(int32_t value) {
+	return value < INT16_MIN ? INT16_MIN : (value > INT16_MAX ? INT16_MAX : value);
+}
+
+ILI9486DisplayList::ILI9486DisplayList(ILI9486 *display, void *memory, uint16_t bytes):
+	display(display),
+	commands((ILI9486DisplayCommand*)memory),
+	capacity(bytes / sizeof(ILI9486DisplayCommand)),
+	count(0),
+	culled(0),
+	clipped(0)
+{}
+
+bool ILI9486DisplayList::fill(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color) {
+	ILI9486DisplayCommand *command = this->add(FILL, xStart, yStart, xEnd, yEnd);
+	if (command == NULL) { return false; }
+
+	command->color = color;
+	return true;
+}
+
+bool ILI9486DisplayList::clear(ILI9486_COLOR color) {
+	return this->fill(0, 0, this->display->getWidth(), this->display->getHeight(), color);
+}
+
+bool ILI9486DisplayList::setPixel(int16_t x, int16_t y, ILI9486_COLOR color) {
+	return this->fill(x, y, x + 1, y + 1, color);
+}
+
+bool ILI9486DisplayList::drawHLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color) {
+	return this->fill(x, y, x + len, y + 1, color);
+}
+
+bool ILI9486DisplayList::drawVLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color) {
+	return this->fill(x, y, x + 1, y + len, color);
+}
+
+bool ILI9486DisplayList::drawLine(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color) {
+	ILI9486DisplayCommand *command = this->add(LINE,
+		xStart < xEnd ? xStart : xEnd, yStart < yEnd ? yStart : yEnd,
+		(xStart > xEnd ? xStart : xEnd) + 1, (yStart > yEnd ? yStart : yEnd) + 1);
+	if (command == NULL) { return false; }
+
+	command->x0 = xStart;
+	command->y0 = yStart;
+	command->x1 = xEnd;
+	command->y1 = yEnd;
+	command->color = color;
+	return true;
+}
+
+bool ILI9486DisplayList::drawCircle(int16_t x, int16_t y, uint16_t radius, ILI9486_COLOR color, bool filled) {
+	ILI9486DisplayCommand *command = this->add(CIRCLE, (int32_t)x - radius, (int32_t)y - radius, (int32_t)x + radius + 1, (int32_t)y + radius + 1);
+	if (command == NULL) { return false; }
+
+	command->x0 = x;
+	command->y0 = y;
+	command->x1 = radius;
+	command->size = filled;
+	command->color = color;
+	return true;
+}
+
+bool ILI9486DisplayList::drawString(int16_t x, int16_t y, const uint8_t *str, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	return this->addString(x, y, str, false, size, color, scale);
+}
+
+bool ILI9486DisplayList::drawString(int16_t x, int16_t y, const __FlashStringHelper *str, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	return this->addString(x, y, (const uint8_t*)str, true, size, color, scale);
+}
+
+bool ILI9486DisplayList::drawString_P(int16_t x, int16_t y, const uint8_t *str, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	return this->addString(x, y, str, true, size, color, scale);
+}
+
+bool ILI9486DisplayList::drawText(int16_t x, int16_t y, const uint8_t *str, uint16_t length, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background, ILI9486::Rotation rotation) {
+	const uint8_t *end = str + length;
+	uint16_t characters = 0;
+	const uint8_t *p = str;
+	while (p < end && *p != '\0') {
+		ILI9486::decodeUTF8(&p);
+		characters++;
+	}
+
+	// Bounds of window written by ILI9486::drawText
+	int32_t width = this->display->getCharWidth(size);
+	int32_t height = this->display->getCharHeight(size);
+	int32_t textWidth = width * characters;
+	int32_t xStart, yStart, xEnd, yEnd;
+
+	switch (rotation) {
+	case ILI9486::ROTATE_0:
+		xStart = (int32_t)x - width / 2;
+		yStart = (int32_t)y + height / 2 + 1 - height;
+		xEnd = xStart + textWidth;
+		yEnd = yStart + height;
+		break;
+	case ILI9486::ROTATE_90:
+		xStart = (int32_t)x - height / 2;
+		yStart = (int32_t)y - width / 2;
+		xEnd = xStart + height;
+		yEnd = yStart + textWidth;
+		break;
+	case ILI9486::ROTATE_180:
+		xStart = (int32_t)x + width / 2 + 1 - textWidth;
+		yStart = (int32_t)y - height / 2;
+		xEnd = xStart + textWidth;
+		yEnd = yStart + height;
+		break;
+	default:
+		xStart = (int32_t)x + height / 2 + 1 - height;
+		yStart = (int32_t)y + width / 2 + 1 - textWidth;
+		xEnd = xStart + height;
+		yEnd = yStart + textWidth;
+		break;
+	}
+
+	ILI9486DisplayCommand *command = this->add(TEXT, xStart, yStart, xEnd, yEnd);
+	if (command == NULL) { return false; }
+
+	command->x0 = x;
+	command->y0 = y;
+	command->x1 = length;
+	command->str = str;
+	command->size = size;
+	command->rotation = rotation;
+	command->color = color;
+	command->background = background;
+	return true;
+}
+
+void ILI9486DisplayList::draw() {
+	Area parts[ILI9486_DISPLAY_LIST_PARTS];
+	this->culled = 0;
+	this->clipped = 0;
+
+	for (uint16_t i = 0; i < this->count; i++) {
+		const ILI9486DisplayCommand *command = &this->commands[i];
+		uint8_t n = this->getVisible(i, parts);
+
+		if (n == 0) {
+			this->culled++;
+			if (command->type == FILL && command->xStart < command->xEnd && command->yStart < command->yEnd) {
+				this->clipped += (uint32_t)(command->xEnd - command->xStart) * (command->yEnd - command->yStart);
+			}
+			continue;
+		}
+
+		if (command->type != FILL) {
+			// Other commands can't be cut, any visible part draws them whole
+			this->execute(command);
+			continue;
+		}
+
+		uint32_t sent = 0;
+		for (uint8_t j = 0; j < n; j++) {
+			this->display->fill(parts[j].xStart, parts[j].yStart, parts[j].xEnd, parts[j].yEnd, command->color);
+			sent += (uint32_t)(parts[j].xEnd - parts[j].xStart) * (parts[j].yEnd - parts[j].yStart);
+		}
+		this->clipped += (uint32_t)(command->xEnd - command->xStart) * (command->yEnd - command->yStart) - sent;
+	}
+}
+
+void ILI9486DisplayList::reset() {
+	this->count = 0;
+}
+
+uint16_t ILI9486DisplayList::getCount() {
+	return this->count;
+}
+
+uint16_t ILI9486DisplayList::getCapacity() {
+	return this->capacity;
+}
+
+uint16_t ILI9486DisplayList::getCulled() {
+	return this->culled;
+}
+
+uint32_t ILI9486DisplayList::getClipped() {
+	return this->clipped;
+}
+
+ILI9486DisplayCommand *ILI9486DisplayList::add(uint8_t type, int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd) {
+	if (this->count == this->capacity) { return NULL; }
+
+	// Bounds are not clamped to display, list may be drawn inside viewport with any origin
+	ILI9486DisplayCommand *command = &this->commands[this->count++];
+	command->type = type;
+	command->xStart = clampCoordinate(xStart);
+	command->yStart = clampCoordinate(yStart);
+	command->xEnd = clampCoordinate(xEnd);
+	command->yEnd = clampCoordinate(yEnd);
+	return command;
+}
+
+bool ILI9486DisplayList::addString(int16_t x, int16_t y, const uint8_t *str, bool progmem, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale) {
+	uint16_t characters = 0;
+	const uint8_t *p = str;
+	while ((progmem ? pgm_read_byte(p) : *p) != '\0') {
+		ILI9486::decodeUTF8(&p, progmem);
+		characters++;
+	}
+
+	// Bounds of character cells drawn by ILI9486::drawString, (x, y) is center of first cell
+	int32_t width = this->display->getCharWidth(size) * scale;
+	int32_t height = this->display->getCharHeight(size) * scale;
+	int32_t xStart = (int32_t)x - width / 2;
+	int32_t yEnd = (int32_t)y + height / 2 + 1;
+
+	ILI9486DisplayCommand *command = this->add(progmem ? STRING_P : STRING, xStart, yEnd - height, xStart + width * characters, yEnd);
+	if (command == NULL) { return false; }
+
+	command->x0 = x;
+	command->y0 = y;
+	command->str = str;
+	command->size = size;
+	command->scale = scale;
+	command->color = color;
+	return true;
+}
+
+uint8_t ILI9486DisplayList::getVisible(uint16_t index, Area *parts) {
+	const ILI9486DisplayCommand *command = &this->commands[index];
+	if (command->xStart >= command->xEnd || command->yStart >= command->yEnd) { return 0; }
+
+	parts[0].xStart = command->xStart;
+	parts[0].yStart = command->yStart;
+	parts[0].xEnd = command->xEnd;
+	parts[0].yEnd = command->yEnd;
+	uint8_t n = 1;
+
+	for (uint16_t i = index + 1; i < this->count && n > 0; i++) {
+		const ILI9486DisplayCommand *cover = &this->commands[i];
+		if (cover->type != FILL && cover->type != TEXT) { continue; }
+
+		for (uint8_t j = 0; j < n;) {
+			Area part = parts[j];
+			if (part.xStart >= cover->xEnd || cover->xStart >= part.xEnd || part.yStart >= cover->yEnd || cover->yStart >= part.yEnd) {
+				j++;
+				continue;
+			}
+
+			// Part is replaced by up to 4 pieces around cover: above, below, left and right of it
+			Area pieces[4];
+			uint8_t m = 0;
+			int16_t top = part.yStart > cover->yStart ? part.yStart : cover->yStart;
+			int16_t bottom = part.yEnd < cover->yEnd ? part.yEnd : cover->yEnd;
+
+			if (part.yStart < cover->yStart) {
+				setArea(&pieces[m++], part.xStart, part.yStart, part.xEnd, cover->yStart);
+			}
+			if (part.yEnd > cover->yEnd) {
+				setArea(&pieces[m++], part.xStart, cover->yEnd, part.xEnd, part.yEnd);
+			}
+			if (part.xStart < cover->xStart) {
+				setArea(&pieces[m++], part.xStart, top, cover->xStart, bottom);
+			}
+			if (part.xEnd > cover->xEnd) {
+				setArea(&pieces[m++], cover->xEnd, top, part.xEnd, bottom);
+			}
+
+			// Too fragmented part is kept whole, cover is drawn over it later anyway
+			if (n - 1 + m > ILI9486_DISPLAY_LIST_PARTS) {
+				j++;
+				continue;
+			}
+
+			// Pieces are appended after remaining parts, they are tested against this cover again, which is harmless
+			parts[j] = parts[--n];
+			for (uint8_t k = 0; k < m; k++) {
+				parts[n++] = pieces[k];
+			}
+		}
+	}
+
+	return n;
+}
+
+void ILI9486DisplayList::setArea(Area *area, int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd) {
+	area->xStart = xStart;
+	area->yStart = yStart;
+	area->xEnd = xEnd;
+	area->yEnd = yEnd;
+}
+
+void ILI9486DisplayList::execute(const ILI9486DisplayCommand *command) {
+	switch (command->type) {
+	case TEXT:
+		this->display->drawText(command->x0, command->y0, command->str, command->x1, (ILI9486::FontSize)command->size, command->color, command->background, (ILI9486::Rotation)command->rotation);
+		break;
+	case STRING:
+		this->display->drawString(command->x0, command->y0, command->str, (ILI9486::FontSize)command->size, command->color, command->scale);
+		break;
+	case STRING_P:
+		this->display->drawString_P(command->x0, command->y0, command->str, (ILI9486::FontSize)command->size, command->color, command->scale);
+		break;
+	case CIRCLE:
+		this->display->drawCircle(command->x0, command->y0, command->x1, command->color, command->size != 0);
+		break;
+	case LINE:
+		this->display->drawLine(command->x0, command->y0, command->x1, command->y1, command->color);
+		break;
+	}
+}
@@ -0,0 +1,104 @@
+/*
+ILI9486DisplayList.h
+Class ILI9486DisplayList records drawing commands and draws them later. Before drawing,
+parts of commands covered by opaque commands recorded after them are dropped, so
+layered screens send every pixel only once.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "ILI9486.h"
+
+// Visible parts of one command kept while it is clipped by opaque commands, more fragmented command is drawn whole
+#define ILI9486_DISPLAY_LIST_PARTS 8
+
+// Recorded command, stored in memory of display list
+struct ILI9486DisplayCommand {
+	uint8_t type;
+	uint8_t size; // Font size or filled flag of circle
+	uint8_t scale;
+	uint8_t rotation;
+	ILI9486_COLOR color;
+	ILI9486_COLOR background;
+	int16_t x0; // Arguments of drawing method
+	int16_t y0;
+	int16_t x1;
+	int16_t y1;
+	const uint8_t *str;
+	int16_t xStart; // Bounds in coordinates of drawing methods, exclusive end
+	int16_t yStart;
+	int16_t xEnd;
+	int16_t yEnd;
+};
+
+class ILI9486DisplayList {
+public:
+	enum CommandType {
+		FILL, // Opaque rectangle, also lines and pixels
+		TEXT, // Text with background, opaque but drawn whole
+		STRING, // Text without background
+		STRING_P, // Text without background stored in FLASH memory
+		CIRCLE,
+		LINE
+	};
+
+	// Memory of given size in bytes holds commands, it is provided by caller, so list can be placed in static or external RAM
+	ILI9486DisplayList(ILI9486 *display, void *memory, uint16_t bytes);
+
+	// Recording methods take the same arguments as ILI9486 methods, they return false when memory is full
+	// Strings are not copied, they have to stay unchanged until list is drawn
+	bool fill(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color);
+	bool clear(ILI9486_COLOR color);
+	bool setPixel(int16_t x, int16_t y, ILI9486_COLOR color);
+	bool drawHLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color);
+	bool drawVLine(int16_t x, int16_t y, uint16_t len, ILI9486_COLOR color);
+	bool drawLine(int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd, ILI9486_COLOR color);
+	bool drawCircle(int16_t x, int16_t y, uint16_t radius, ILI9486_COLOR color, bool filled = false);
+	bool drawString(int16_t x, int16_t y, const uint8_t *str, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale = 1);
+	bool drawString(int16_t x, int16_t y, const __FlashStringHelper *str, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale = 1);
+	bool drawString_P(int16_t x, int16_t y, const uint8_t *str, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale = 1);
+	bool drawText(int16_t x, int16_t y, const uint8_t *str, uint16_t length, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background, ILI9486::Rotation rotation = ILI9486::ROTATE_0);
+
+	void draw(); // Draw recorded commands in order, covered parts are skipped, list is kept and can be drawn again
+	void reset(); // Drop recorded commands
+
+	uint16_t getCount(); // Number of recorded commands
+	uint16_t getCapacity(); // Number of commands which fit in memory
+	uint16_t getCulled(); // Commands skipped by last draw, because they were fully covered
+	uint32_t getClipped(); // Pixels of rectangles not sent by last draw, because they were covered
+
+private:
+	struct Area {
+		int16_t xStart;
+		int16_t yStart;
+		int16_t xEnd;
+		int16_t yEnd;
+	};
+
+	ILI9486DisplayCommand *add(uint8_t type, int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd); // Next free command with given bounds clipped to display, NULL when memory is full
+	bool addString(int16_t x, int16_t y, const uint8_t *str, bool progmem, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale);
+	uint8_t getVisible(uint16_t index, Area *parts); // Split bounds of command into parts not covered by following opaque commands, returns number of parts
+	static void setArea(Area *area, int16_t xStart, int16_t yStart, int16_t xEnd, int16_t yEnd);
+	void execute(const ILI9486DisplayCommand *command);
+
+	ILI9486 *display;
+	ILI9486DisplayCommand *commands;
+	uint16_t capacity;
+	uint16_t count;
+
+	uint16_t culled;
+	uint32_t clipped;
+};
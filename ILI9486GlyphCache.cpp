@@ -0,0 +1,118 @@
+/*
+ILI9486GlyphCache.cpp
+Implementation of ILI9486GlyphCache class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486GlyphCache.h"
+
+ILI9486GlyphCache::ILI9486GlyphCache(ILI9486 *display, void *memory, uint32_t bytes, ILI9486::FontSize largest):
+	display(display),
+	clock(0),
+	hits(0),
+	misses(0)
+{
+	this->slotPixels = display->getCharWidth(largest) * display->getCharHeight(largest);
+
+	uint32_t slotBytes = sizeof(ILI9486CachedGlyph) + this->slotPixels * sizeof(ILI9486_COLOR);
+	this->capacity = bytes / slotBytes;
+
+	this->glyphs = (ILI9486CachedGlyph*)memory;
+	this->cells = (ILI9486_COLOR*)(this->glyphs + this->capacity);
+
+	this->clear();
+}
+
+void ILI9486GlyphCache::drawChar(uint16_t x, uint16_t y, uint8_t character, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background) {
+	ILI9486_COLOR *cell = this->getCell(character, size, color, background);
+
+	if (cell == NULL) {
+		// Cache has no memory or font is larger than slots
+		this->display->drawChar(x, y, character, size, color, 255, background);
+		return;
+	}
+
+	this->display->drawCell(x, y, size, cell);
+}
+
+void ILI9486GlyphCache::drawString(uint16_t x, uint16_t y, const uint8_t *str, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background) {
+	uint16_t width = this->display->getCharWidth(size);
+
+	while (*str != '\0') {
+		this->drawChar(x, y, ILI9486::cellChar(ILI9486::decodeUTF8(&str)), size, color, background);
+		x += width;
+	}
+}
+
+void ILI9486GlyphCache::clear() {
+	for (uint16_t i = 0; i < this->capacity; i++) {
+		this->glyphs[i].size = 0;
+		this->glyphs[i].used = 0;
+	}
+}
+
+uint16_t ILI9486GlyphCache::getCapacity() {
+	return this->capacity;
+}
+
+uint32_t ILI9486GlyphCache::getHits() {
+	return this->hits;
+}
+
+uint32_t ILI9486GlyphCache::getMisses() {
+	return this->misses;
+}
+
+void ILI9486GlyphCache::resetCounters() {
+	this->hits = 0;
+	this->misses = 0;
+}
+
+ILI9486_COLOR *ILI9486GlyphCache::getCell(uint8_t character, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background) {
+	uint16_t pixels = this->display->getCharWidth(size) * this->display->getCharHeight(size);
+	if (this->capacity == 0 || pixels > this->slotPixels) { return NULL; }
+
+	character = ILI9486::cellChar(character);
+	this->clock++;
+
+	// Single pass finds cached cell or least recently used slot, empty slots have the lowest use counter
+	uint16_t victim = 0;
+	for (uint16_t i = 0; i < this->capacity; i++) {
+		ILI9486CachedGlyph *glyph = &this->glyphs[i];
+
+		if (glyph->size == size && glyph->character == character && glyph->color == color && glyph->background == background) {
+			glyph->used = this->clock;
+			this->hits++;
+			return this->cells + (uint32_t)i * this->slotPixels;
+		}
+
+		if (glyph->used < this->glyphs[victim].used) {
+			victim = i;
+		}
+	}
+
+	ILI9486CachedGlyph *glyph = &this->glyphs[victim];
+	glyph->used = this->clock;
+	glyph->color = color;
+	glyph->background = background;
+	glyph->size = size;
+	glyph->character = character;
+	this->misses++;
+
+	ILI9486_COLOR *cell = this->cells + (uint32_t)victim * this->slotPixels;
+	this->display->expandChar(character, size, color, background, cell);
+
+	return cell;
+}
@@ -0,0 +1,60 @@
+/*
+ILI9486GlyphCache.h
+Class ILI9486GlyphCache keeps recently drawn character cells expanded to RGB565 pixels,
+so they are written to the display without decoding font bitmaps.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "ILI9486.h"
+
+// Description of cached character cell, stored at the beginning of cache memory
+struct ILI9486CachedGlyph {
+	uint32_t used; // Value of use counter on last access, least recently used cell has the lowest one
+	ILI9486_COLOR color;
+	ILI9486_COLOR background;
+	uint8_t size; // Font size, 0 for empty slot
+	uint8_t character;
+};
+
+class ILI9486GlyphCache {
+public:
+	// Memory of given size in bytes is split into slots holding one cell of largest font size which will be cached
+	// Memory is provided by caller, so cache can be placed in static or external RAM
+	ILI9486GlyphCache(ILI9486 *display, void *memory, uint32_t bytes, ILI9486::FontSize largest = ILI9486::XL);
+
+	void drawChar(uint16_t x, uint16_t y, uint8_t character, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background); // Draw character cell with background from cache
+	void drawString(uint16_t x, uint16_t y, const uint8_t *str, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background); // Strings are UTF-8 encoded, like in ILI9486::drawString
+	void clear(); // Drop all cached cells
+
+	uint16_t getCapacity(); // Number of cells which fit in cache memory
+	uint32_t getHits(); // Number of characters drawn from cache
+	uint32_t getMisses(); // Number of characters which had to be expanded
+	void resetCounters();
+
+private:
+	ILI9486_COLOR *getCell(uint8_t character, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background); // Find cell, on miss least recently used slot is replaced
+
+	ILI9486 *display;
+	ILI9486CachedGlyph *glyphs;
+	ILI9486_COLOR *cells; // Pixels of slots, placed after glyphs
+	uint16_t slotPixels;
+	uint16_t capacity;
+
+	uint32_t clock; // Use counter
+	uint32_t hits;
+	uint32_t misses;
+};
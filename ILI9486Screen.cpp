@@ -0,0 +1,155 @@
+/*
+ILI9486Screen.cpp
+Implementation of ILI9486Screen class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486Screen.h"
+
+ILI9486Screen::ILI9486Screen(ILI9486 *display, const uint8_t *data, bool progmem):
+	display(display),
+	data(data),
+	position(data),
+	progmem(progmem)
+{}
+
+bool ILI9486Screen::isValid() {
+	this->position = this->data;
+
+	bool valid = true;
+	for (uint8_t i = 0; i < ILI9486_SCREEN_HEADER; i++) {
+		valid = this->readByte() == (uint8_t)ILI9486_SCREEN_MAGIC[i] && valid;
+	}
+
+	return valid;
+}
+
+bool ILI9486Screen::draw(int16_t x, int16_t y) {
+	if (!this->isValid()) { return false; }
+
+	ILI9486_COLOR color = ILI9486_WHITE;
+	ILI9486_COLOR background = ILI9486_BLACK;
+
+	while (true) {
+		uint8_t opcode = this->readByte();
+
+		switch (opcode) {
+		case END:
+			return true;
+		case COLOR:
+			color = this->readWord();
+			break;
+		case BACKGROUND:
+			background = this->readWord();
+			break;
+		case CLEAR:
+			// Screen sized fill at origin, panel drawn away from corner doesn't clear whole screen
+			this->display->fill(x, y, x + this->display->getWidth(), y + this->display->getHeight(), color);
+			break;
+		case FILL:
+		case FILLS: {
+			// Bulk fills share color and opcode
+			uint16_t n = opcode == FILLS ? this->readNumber() : 1;
+			for (uint16_t i = 0; i < n; i++) {
+				int16_t left = x + this->readNumber();
+				int16_t top = y + this->readNumber();
+				uint16_t width = this->readNumber();
+				uint16_t height = this->readNumber();
+				this->display->fill(left, top, left + width, top + height, color);
+			}
+			break;
+		}
+		case LINE: {
+			int16_t xStart = x + this->readNumber();
+			int16_t yStart = y + this->readNumber();
+			int16_t xEnd = x + this->readNumber();
+			int16_t yEnd = y + this->readNumber();
+			this->display->drawLine(xStart, yStart, xEnd, yEnd, color);
+			break;
+		}
+		case CIRCLE:
+		case FILLED_CIRCLE: {
+			int16_t centerX = x + this->readNumber();
+			int16_t centerY = y + this->readNumber();
+			uint16_t radius = this->readNumber();
+			this->display->drawCircle(centerX, centerY, radius, color, opcode == FILLED_CIRCLE);
+			break;
+		}
+		case STRING: {
+			ILI9486::FontSize size = (ILI9486::FontSize)this->readByte();
+			uint8_t scale = this->readByte();
+			int16_t left = x + this->readNumber();
+			int16_t top = y + this->readNumber();
+
+			// String is drawn straight from bytecode
+			if (this->progmem) {
+				this->display->drawString_P(left, top, this->position, size, color, scale);
+			} else {
+				this->display->drawString(left, top, this->position, size, color, scale);
+			}
+
+			while (this->readByte() != '\0');
+			break;
+		}
+		case TEXT: {
+			ILI9486::FontSize size = (ILI9486::FontSize)this->readByte();
+			ILI9486::Rotation rotation = (ILI9486::Rotation)this->readByte();
+			int16_t left = x + this->readNumber();
+			int16_t top = y + this->readNumber();
+			uint16_t length = this->readNumber();
+
+			if (this->progmem) {
+				uint8_t text[ILI9486_SCREEN_TEXT];
+				if (length > ILI9486_SCREEN_TEXT) { return false; }
+				memcpy_P(text, this->position, length);
+				this->display->drawText(left, top, text, length, size, color, background, rotation);
+			} else {
+				this->display->drawText(left, top, this->position, length, size, color, background, rotation);
+			}
+
+			this->position += length;
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+}
+
+uint8_t ILI9486Screen::readByte() {
+	uint8_t value = this->progmem ? pgm_read_byte(this->position) : *this->position;
+	this->position++;
+	return value;
+}
+
+uint16_t ILI9486Screen::readWord() {
+	uint16_t low = this->readByte();
+	return low | ((uint16_t)this->readByte() << 8);
+}
+
+uint16_t ILI9486Screen::readNumber() {
+	uint16_t value = 0;
+	uint8_t shift = 0;
+	uint8_t byte;
+
+	// 16 bit numbers take at most 3 bytes, malformed data can't shift past width of value
+	do {
+		byte = this->readByte();
+		value |= (uint16_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while ((byte & 0x80) && shift < 21);
+
+	return value;
+}
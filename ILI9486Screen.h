@@ -0,0 +1,78 @@
+/*
+ILI9486Screen.h
+Class ILI9486Screen draws static screens compiled into compact drawing bytecode by
+tools/screencompile.py. Bytecode is read from RAM or FLASH (PROGMEM), so fixed layouts
+take a few bytes per primitive instead of code of every drawing call.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Format:
+header:      "ISCR"
+instruction: opcode byte followed by operands, numbers are unsigned varints (7 bits per byte,
+             least significant first, highest bit set when more bytes follow), colors are
+             little endian uint16_t. Coordinates are relative to origin given to draw.
+END                                     end of screen
+COLOR color                             set color used by following primitives
+BACKGROUND color                        set background of following TEXT
+CLEAR                                   fill screen sized rectangle at origin with color
+FILL x y width height                   fill rectangle with color
+FILLS n, n times x y width height       fill n rectangles with color
+LINE xStart yStart xEnd yEnd
+CIRCLE x y radius
+FILLED_CIRCLE x y radius
+STRING size scale x y, characters, 0    text without background, size is FontSize value
+TEXT size rotation x y length, length characters    text with background
+*/
+
+#pragma once
+
+#include "ILI9486.h"
+
+#define ILI9486_SCREEN_MAGIC "ISCR"
+#define ILI9486_SCREEN_HEADER 4 // Size of header in bytes
+#define ILI9486_SCREEN_TEXT 64 // Maximal length of TEXT in bytes, text in FLASH memory is copied to stack
+
+class ILI9486Screen {
+public:
+	enum Opcode {
+		END,
+		COLOR,
+		BACKGROUND,
+		CLEAR,
+		FILL,
+		FILLS,
+		LINE,
+		CIRCLE,
+		FILLED_CIRCLE,
+		STRING,
+		TEXT
+	};
+
+	ILI9486Screen(ILI9486 *display, const uint8_t *data, bool progmem = true); // Screen in FLASH memory or in RAM
+
+	bool isValid(); // Whether header was recognized
+	bool draw(int16_t x = 0, int16_t y = 0); // Draw screen with origin at (x, y), returns false when unknown opcode was found
+
+private:
+	uint8_t readByte();
+	uint16_t readWord();
+	uint16_t readNumber(); // Varint
+
+	ILI9486 *display;
+	const uint8_t *data;
+	const uint8_t *position;
+	bool progmem;
+};
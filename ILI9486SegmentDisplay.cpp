@@ -0,0 +1,205 @@
+/*
+ILI9486SegmentDisplay.cpp
+Implementation of ILI9486SegmentDisplay class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486SegmentDisplay.h"
+
+// Segments of characters from ' ' to '_', lowercase letters use uppercase entries
+static const uint8_t SevenSegmentTable[] PROGMEM = {
+	0x00, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x02, 0x39, 0x0F, 0x00, 0x00, 0x00, 0x40, 0x00, 0x52, // ' ' - '/'
+	0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F, 0x00, 0x00, 0x00, 0x48, 0x00, 0x53, // '0' - '?'
+	0x00, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71, 0x3D, 0x76, 0x06, 0x1E, 0x00, 0x38, 0x00, 0x54, 0x5C, // '@' - 'O'
+	0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x00, 0x00, 0x00, 0x6E, 0x5B, 0x39, 0x64, 0x0F, 0x23, 0x08 // 'P' - '_'
+};
+
+static const uint16_t FourteenSegmentTable[] PROGMEM = {
+	0x0000, 0x0200, 0x0220, 0x12CE, 0x12ED, 0x0C24, 0x235D, 0x0400, 0x2400, 0x0900, 0x3FC0, 0x12C0, 0x0800, 0x00C0, 0x0000, 0x0C00, // ' ' - '/'
+	0x0C3F, 0x0006, 0x00DB, 0x008F, 0x00E6, 0x2069, 0x00FD, 0x0007, 0x00FF, 0x00EF, 0x1200, 0x0A00, 0x2400, 0x00C8, 0x0900, 0x1083, // '0' - '?'
+	0x02BB, 0x00F7, 0x128F, 0x0039, 0x120F, 0x00F9, 0x0071, 0x00BD, 0x00F6, 0x1209, 0x001E, 0x2470, 0x0038, 0x0536, 0x2136, 0x003F, // '@' - 'O'
+	0x00F3, 0x203F, 0x20F3, 0x00ED, 0x1201, 0x003E, 0x0C30, 0x2836, 0x2D00, 0x1500, 0x0C09, 0x0039, 0x2100, 0x000F, 0x2800, 0x0008 // 'P' - '_'
+};
+
+ILI9486SegmentDisplay::ILI9486SegmentDisplay(ILI9486 *display, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t thickness, uint8_t digits, ILI9486_COLOR color, ILI9486_COLOR background, Style style):
+	display(display),
+	x(x),
+	y(y),
+	width(width),
+	height(height),
+	thickness(thickness),
+	digits(digits < ILI9486_SEGMENT_DIGITS ? digits : ILI9486_SEGMENT_DIGITS),
+	color(color),
+	background(background),
+	style(style),
+	valid(false)
+{}
+
+void ILI9486SegmentDisplay::setText(const uint8_t *str) {
+	for (uint8_t i = 0; i < this->digits; i++) {
+		uint8_t character = ' ';
+		if (*str != '\0') {
+			character = ILI9486::cellChar(ILI9486::decodeUTF8(&str));
+		}
+
+		this->update(i, getSegments(character, this->style));
+	}
+
+	this->valid = true;
+}
+
+void ILI9486SegmentDisplay::setNumber(int32_t value) {
+	// Digits are computed from the right, without sprintf
+	uint32_t magnitude = value < 0 ? -(uint32_t)value : value;
+	int16_t i = this->digits - 1;
+
+	do {
+		this->update(i--, getSegments('0' + magnitude % 10, this->style));
+		magnitude /= 10;
+	} while (magnitude != 0 && i >= 0);
+
+	if (value < 0 && i >= 0) {
+		this->update(i--, getSegments('-', this->style));
+	}
+
+	while (i >= 0) {
+		this->update(i--, 0);
+	}
+
+	this->valid = true;
+}
+
+void ILI9486SegmentDisplay::setSegments(uint8_t digit, uint16_t segments) {
+	if (digit >= this->digits) { return; }
+
+	if (!this->valid) {
+		// Other digits are unknown, so they are drawn blank
+		for (uint8_t i = 0; i < this->digits; i++) {
+			this->update(i, 0);
+		}
+
+		this->valid = true;
+	}
+
+	this->update(digit, segments);
+}
+
+void ILI9486SegmentDisplay::setColor(ILI9486_COLOR color, ILI9486_COLOR background) {
+	this->color = color;
+	this->background = background;
+	this->invalidate();
+}
+
+void ILI9486SegmentDisplay::invalidate() {
+	this->valid = false;
+}
+
+void ILI9486SegmentDisplay::clear() {
+	uint16_t pitch = this->width + this->thickness;
+	this->display->fill(this->x, this->y, this->x + pitch * this->digits - this->thickness, this->y + this->height, this->background);
+
+	for (uint8_t i = 0; i < this->digits; i++) {
+		this->drawn[i] = 0;
+	}
+
+	this->valid = true;
+}
+
+uint16_t ILI9486SegmentDisplay::getSegments(uint8_t character, Style style) {
+	if (character >= 'a' && character <= 'z') {
+		character -= 'a' - 'A';
+	}
+
+	if (character < ' ' || character > '_') { return 0; }
+
+	if (style == SEVEN_SEGMENT) {
+		return pgm_read_byte(&SevenSegmentTable[character - ' ']);
+	}
+
+	return pgm_read_word(&FourteenSegmentTable[character - ' ']);
+}
+
+void ILI9486SegmentDisplay::update(uint8_t digit, uint16_t segments) {
+	// Unknown screen content is overwritten by all segments, lit or not
+	uint16_t all = this->style == SEVEN_SEGMENT ? 0x007F : 0x3FFF;
+	uint16_t changed = this->valid ? (this->drawn[digit] ^ segments) : all;
+
+	for (uint16_t segment = 1; segment <= 0x2000; segment <<= 1) {
+		if (changed & segment & all) {
+			this->drawSegment(digit, segment, (segments & segment) ? this->color : this->background);
+		}
+	}
+
+	this->drawn[digit] = segments;
+}
+
+void ILI9486SegmentDisplay::drawSegment(uint8_t digit, uint16_t segment, ILI9486_COLOR color) {
+	// Segments don't overlap, so turning one off never erases its neighbours
+	uint16_t t = this->thickness;
+	uint16_t left = this->x + digit * (this->width + t);
+	uint16_t right = left + this->width;
+	uint16_t bottom = this->y;
+	uint16_t top = bottom + this->height;
+	uint16_t middle = bottom + (this->height - t) / 2; // Lower edge of middle segment
+	uint16_t center = left + (this->width - t) / 2; // Left edge of center segments
+
+	switch (segment) {
+	case SEGMENT_A: this->display->fill(left + t, top - t, right - t, top, color); break;
+	case SEGMENT_B: this->display->fill(right - t, middle + t, right, top - t, color); break;
+	case SEGMENT_C: this->display->fill(right - t, bottom + t, right, middle, color); break;
+	case SEGMENT_D: this->display->fill(left + t, bottom, right - t, bottom + t, color); break;
+	case SEGMENT_E: this->display->fill(left, bottom + t, left + t, middle, color); break;
+	case SEGMENT_F: this->display->fill(left, middle + t, left + t, top - t, color); break;
+	case SEGMENT_G1:
+		// Seven segment style has single middle segment
+		this->display->fill(left + t, middle, this->style == SEVEN_SEGMENT ? right - t : center, middle + t, color);
+		break;
+	case SEGMENT_G2: this->display->fill(center + t, middle, right - t, middle + t, color); break;
+	case SEGMENT_H: this->drawDiagonal(left + t, middle + t, center, top - t, false, color); break;
+	case SEGMENT_I: this->display->fill(center, middle + t, center + t, top - t, color); break;
+	case SEGMENT_J: this->drawDiagonal(center + t, middle + t, right - t, top - t, true, color); break;
+	case SEGMENT_K: this->drawDiagonal(left + t, bottom + t, center, middle, true, color); break;
+	case SEGMENT_L: this->display->fill(center, bottom + t, center + t, middle, color); break;
+	case SEGMENT_M: this->drawDiagonal(center + t, bottom + t, right - t, middle, false, color); break;
+	}
+}
+
+void ILI9486SegmentDisplay::drawDiagonal(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, bool rising, ILI9486_COLOR color) {
+	if (xEnd <= xStart || yEnd <= yStart) { return; }
+
+	uint16_t boxWidth = xEnd - xStart;
+	uint16_t boxHeight = yEnd - yStart;
+	uint16_t span = this->thickness < boxWidth ? this->thickness : boxWidth;
+	uint16_t travel = boxWidth - span; // Horizontal distance covered by stroke
+
+	// Rows with the same span position are written as one rectangle
+	uint16_t runStart = 0;
+	uint16_t runOffset = 0;
+
+	for (uint16_t row = 0; row <= boxHeight; row++) {
+		uint16_t offset = 0;
+		if (row < boxHeight && boxHeight > 1) {
+			offset = (uint32_t)row * travel / (boxHeight - 1);
+		}
+
+		if (row == boxHeight || (row > 0 && offset != runOffset)) {
+			uint16_t spanStart = rising ? xStart + runOffset : xEnd - span - runOffset;
+			this->display->fill(spanStart, yStart + runStart, spanStart + span, yStart + row, color);
+			runStart = row;
+		}
+
+		runOffset = offset;
+	}
+}
@@ -0,0 +1,84 @@
+/*
+ILI9486SegmentDisplay.h
+Class ILI9486SegmentDisplay represent row of large seven or fourteen segment digits,
+which are redrawn only where segments changed.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "ILI9486.h"
+
+// Maximum number of digits of segment display
+#define ILI9486_SEGMENT_DIGITS 12
+
+class ILI9486SegmentDisplay {
+public:
+	enum Style {
+		SEVEN_SEGMENT, // Digits and few letters
+		FOURTEEN_SEGMENT // Digits, letters and symbols
+	};
+
+	// Segments bits, g is whole middle segment for seven segment style
+	// Diagonals are named after quarter of digit they cross
+	enum Segment {
+		SEGMENT_A = 0x0001, // Top
+		SEGMENT_B = 0x0002, // Upper right
+		SEGMENT_C = 0x0004, // Lower right
+		SEGMENT_D = 0x0008, // Bottom
+		SEGMENT_E = 0x0010, // Lower left
+		SEGMENT_F = 0x0020, // Upper left
+		SEGMENT_G1 = 0x0040, // Middle left
+		SEGMENT_G2 = 0x0080, // Middle right
+		SEGMENT_H = 0x0100, // Upper left diagonal
+		SEGMENT_I = 0x0200, // Upper center
+		SEGMENT_J = 0x0400, // Upper right diagonal
+		SEGMENT_K = 0x0800, // Lower left diagonal
+		SEGMENT_L = 0x1000, // Lower center
+		SEGMENT_M = 0x2000 // Lower right diagonal
+	};
+
+	// (x, y) is corner of first digit with lowest coordinates, top segment is drawn at y + height like first line of text
+	// Digits are placed every width + thickness pixels
+	ILI9486SegmentDisplay(ILI9486 *display, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t thickness, uint8_t digits, ILI9486_COLOR color, ILI9486_COLOR background, Style style = SEVEN_SEGMENT);
+
+	void setText(const uint8_t *str); // Show one character per digit, only toggled segments are written
+	void setNumber(int32_t value); // Show number aligned to the right
+	void setSegments(uint8_t digit, uint16_t segments); // Show custom segments combination on given digit
+	void setColor(ILI9486_COLOR color, ILI9486_COLOR background); // Change colors, all segments are redrawn on next update
+	void invalidate(); // Redraw all segments on next update, use after screen was drawn over
+	void clear(); // Fill whole area of digits with background color
+
+	static uint16_t getSegments(uint8_t character, Style style); // Segments lit for character, unknown characters are blank
+
+private:
+	void update(uint8_t digit, uint16_t segments); // Draw segments which differ from drawn ones
+	void drawSegment(uint8_t digit, uint16_t segment, ILI9486_COLOR color); // Draw single segment with fill bursts
+	void drawDiagonal(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, bool rising, ILI9486_COLOR color); // Draw diagonal stroke inside box, rows with same span are merged
+
+	ILI9486 *display;
+	uint16_t x;
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+	uint16_t thickness;
+	uint8_t digits;
+	ILI9486_COLOR color;
+	ILI9486_COLOR background;
+	Style style;
+
+	uint16_t drawn[ILI9486_SEGMENT_DIGITS]; // Segments lit on last render
+	bool valid; // Whether screen content matches drawn segments
+};
@@ -0,0 +1,206 @@
+/*
+ILI9486TextCursor.cpp
+Implementation of ILI9486TextCursor class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486TextCursor.h"
+
+ILI9486TextCursor::ILI9486TextCursor(ILI9486 *display, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale):
+	display(display),
+	size(size),
+	scale(scale),
+	color(color),
+	background(ILI9486_BLACK),
+	opaque(false),
+	startX(0),
+	x(0),
+	y(0),
+	pendingLength(0)
+{}
+
+void ILI9486TextCursor::setCursor(uint16_t x, uint16_t y) {
+	this->startX = x;
+	this->x = x;
+	this->y = y;
+}
+
+void ILI9486TextCursor::setColor(ILI9486_COLOR color) {
+	this->color = color;
+	this->opaque = false;
+}
+
+void ILI9486TextCursor::setColor(ILI9486_COLOR color, ILI9486_COLOR background) {
+	this->color = color;
+	this->background = background;
+	this->opaque = true;
+}
+
+uint16_t ILI9486TextCursor::getX() {
+	return this->x;
+}
+
+uint16_t ILI9486TextCursor::getY() {
+	return this->y;
+}
+
+size_t ILI9486TextCursor::write(uint8_t character) {
+	// Byte which is not continuation ends incomplete character early, collected bytes are decoded as U+FFFD
+	// and byte is handled as ASCII character or lead byte of next character
+	if (this->pendingLength > 0 && (character & 0xC0) != 0x80) {
+		this->drawPending();
+	}
+
+	if (character == '\n') {
+		// Next line is drawn in direction in which character lines are drawn
+		this->x = this->startX;
+		this->y -= this->display->getCharHeight(this->size) * this->scale;
+		return 1;
+	}
+
+	if (character == '\r') { return 1; }
+
+	// Collect bytes of multibyte character, lead byte tells its length
+	if (this->pendingLength == 0 && character < 0x80) {
+		this->drawCharacter(character);
+		return 1;
+	}
+
+	this->pending[this->pendingLength++] = character;
+	uint8_t expected = ((this->pending[0] & 0xE0) == 0xC0) ? 2 : ((this->pending[0] & 0xF0) == 0xE0) ? 3 : 4;
+
+	if (this->pendingLength >= expected) {
+		this->drawPending();
+	}
+
+	return 1;
+}
+
+size_t ILI9486TextCursor::printInt(int32_t value, uint8_t width) {
+	// Magnitude of INT32_MIN doesn't fit in int32_t
+	uint32_t magnitude = (value < 0) ? (uint32_t)(-(value + 1)) + 1 : (uint32_t)value;
+	uint8_t digits = countDigits(magnitude);
+	uint8_t length = digits + ((value < 0) ? 1 : 0);
+	size_t n = 0;
+
+	for (; length + n < width; n++) {
+		this->drawCharacter(' ');
+	}
+
+	if (value < 0) {
+		this->drawCharacter('-');
+		n++;
+	}
+
+	uint32_t divisor = 1;
+	for (uint8_t i = 1; i < digits; i++) {
+		divisor *= 10;
+	}
+
+	return n + this->printDigits(magnitude, divisor);
+}
+
+size_t ILI9486TextCursor::printFixed(int32_t value, uint8_t decimals, uint8_t width) {
+	uint32_t magnitude = (value < 0) ? (uint32_t)(-(value + 1)) + 1 : (uint32_t)value;
+
+	uint32_t scale = 1;
+	for (uint8_t i = 0; i < decimals; i++) {
+		scale *= 10;
+	}
+
+	uint32_t integer = magnitude / scale;
+	uint8_t digits = countDigits(integer);
+	uint8_t length = digits + ((value < 0) ? 1 : 0) + ((decimals > 0) ? decimals + 1 : 0);
+	size_t n = 0;
+
+	for (; length + n < width; n++) {
+		this->drawCharacter(' ');
+	}
+
+	if (value < 0) {
+		this->drawCharacter('-');
+		n++;
+	}
+
+	uint32_t divisor = 1;
+	for (uint8_t i = 1; i < digits; i++) {
+		divisor *= 10;
+	}
+
+	n += this->printDigits(integer, divisor);
+
+	if (decimals > 0) {
+		// Fraction keeps leading zeros, so its digits start from scale / 10 place
+		this->drawCharacter('.');
+		n += 1 + this->printDigits(magnitude % scale, scale / 10);
+	}
+
+	return n;
+}
+
+void ILI9486TextCursor::drawCharacter(uint8_t character) {
+	uint16_t width = this->display->getCharWidth(this->size) * this->scale;
+
+	if (this->opaque && this->scale == 1) {
+		this->display->drawChar(this->x, this->y, character, this->size, this->color, 255, this->background);
+	} else {
+		if (this->opaque) {
+			// Scaled characters are drawn on cleared cell
+			uint16_t height = this->display->getCharHeight(this->size) * this->scale;
+			uint16_t left = this->x - (width / 2);
+			uint16_t bottom = this->y + (height / 2);
+			this->display->fill(left, bottom + 1 - height, left + width, bottom + 1, this->background);
+		}
+
+		this->display->drawChar(this->x, this->y, character, this->size, this->color, this->scale);
+	}
+
+	this->x += width;
+}
+
+void ILI9486TextCursor::drawPending() {
+	uint8_t sequence[5];
+	memcpy(sequence, this->pending, this->pendingLength);
+	sequence[this->pendingLength] = '\0';
+	const uint8_t *p = sequence;
+
+	this->drawCharacter(ILI9486::cellChar(ILI9486::decodeUTF8(&p)));
+	this->pendingLength = 0;
+}
+
+size_t ILI9486TextCursor::printDigits(uint32_t value, uint32_t divisor) {
+	size_t n = 0;
+
+	for (; divisor > 0; divisor /= 10) {
+		uint8_t digit = value / divisor;
+		value -= digit * divisor;
+
+		this->drawCharacter('0' + digit);
+		n++;
+	}
+
+	return n;
+}
+
+uint8_t ILI9486TextCursor::countDigits(uint32_t value) {
+	uint8_t digits = 1;
+
+	while (value >= 10) {
+		value /= 10;
+		digits++;
+	}
+
+	return digits;
+}
@@ -0,0 +1,63 @@
+/*
+ILI9486TextCursor.h
+Class ILI9486TextCursor draws text on ILI9486 display through
+Arduino Print interface, with heap free number formatting.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <Print.h>
+
+#include "ILI9486.h"
+
+class ILI9486TextCursor : public Print {
+public:
+	ILI9486TextCursor(ILI9486 *display, ILI9486::FontSize size, ILI9486_COLOR color, uint8_t scale = 1);
+
+	void setCursor(uint16_t x, uint16_t y); // Center of next character, '\n' returns to x
+	void setColor(ILI9486_COLOR color); // Draw only character pixels
+	void setColor(ILI9486_COLOR color, ILI9486_COLOR background); // Draw whole character cells with background
+	uint16_t getX(); // Center of next character
+	uint16_t getY();
+
+	size_t write(uint8_t character); // Print interface, UTF-8 bytes are collected until character is complete
+	using Print::write;
+
+	// Digits are drawn as they are computed, without buffer or printf
+	// width pads number with spaces on the left, useful for right aligned readouts
+	size_t printInt(int32_t value, uint8_t width = 0);
+	size_t printFixed(int32_t value, uint8_t decimals, uint8_t width = 0); // Print value / 10^decimals, e.g. printFixed(-1234, 2) prints "-12.34"
+
+private:
+	void drawCharacter(uint8_t character); // Draw at cursor and move cursor
+	void drawPending(); // Decode and draw collected bytes of UTF-8 character
+	size_t printDigits(uint32_t value, uint32_t divisor); // Draw digits of value from divisor place down, returns number of digits
+	static uint8_t countDigits(uint32_t value);
+
+	ILI9486 *display;
+	ILI9486::FontSize size;
+	uint8_t scale;
+	ILI9486_COLOR color;
+	ILI9486_COLOR background;
+	bool opaque; // Whether background is drawn
+
+	uint16_t startX; // x set by setCursor
+	uint16_t x;
+	uint16_t y;
+
+	uint8_t pending[4]; // Bytes of incomplete UTF-8 character
+	uint8_t pendingLength;
+};
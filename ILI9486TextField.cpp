@@ -0,0 +1,81 @@
+/*
+ILI9486TextField.cpp
+Implementation of ILI9486TextField class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486TextField.h"
+
+ILI9486TextField::ILI9486TextField(ILI9486 *display, uint16_t x, uint16_t y, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background):
+	display(display),
+	x(x),
+	y(y),
+	size(size),
+	color(color),
+	background(background),
+	length(0),
+	valid(false)
+{}
+
+void ILI9486TextField::setText(const uint8_t *str) {
+	uint8_t i = 0;
+
+	while (*str != '\0' && i < ILI9486_TEXTFIELD_LENGTH) {
+		uint8_t character = ILI9486::cellChar(ILI9486::decodeUTF8(&str));
+
+		// Cell is drawn with its background, so no erase pass is needed
+		if (!this->valid || i >= this->length || this->text[i] != character) {
+			this->drawCell(i, character);
+			this->text[i] = character;
+		}
+
+		i++;
+	}
+
+	// Erase cells left after longer text, invalid field still has them on screen, only in other colors
+	for (uint8_t j = i; j < this->length; j++) {
+		this->drawCell(j, ' ');
+	}
+
+	this->length = i;
+	this->valid = true;
+}
+
+void ILI9486TextField::setColor(ILI9486_COLOR color, ILI9486_COLOR background) {
+	this->color = color;
+	this->background = background;
+	this->invalidate();
+}
+
+void ILI9486TextField::invalidate() {
+	this->valid = false;
+}
+
+void ILI9486TextField::clear() {
+	for (uint8_t i = 0; i < this->length; i++) {
+		this->drawCell(i, ' ');
+	}
+
+	this->length = 0;
+}
+
+uint8_t ILI9486TextField::getLength() {
+	return this->length;
+}
+
+void ILI9486TextField::drawCell(uint8_t i, uint8_t character) {
+	uint16_t cellX = this->x + i * this->display->getCharWidth(this->size);
+	this->display->drawChar(cellX, this->y, character, this->size, this->color, 255, this->background);
+}
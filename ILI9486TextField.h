@@ -0,0 +1,51 @@
+/*
+ILI9486TextField.h
+Class ILI9486TextField represent text displayed at fixed position,
+which is redrawn only where characters changed.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "ILI9486.h"
+
+// Maximum number of characters remembered by text field, longer text is truncated
+#define ILI9486_TEXTFIELD_LENGTH 32
+
+class ILI9486TextField {
+public:
+	ILI9486TextField(ILI9486 *display, uint16_t x, uint16_t y, ILI9486::FontSize size, ILI9486_COLOR color, ILI9486_COLOR background); // (x, y) is center of first character, like in drawString
+
+	void setText(const uint8_t *str); // Draw text, only cells with changed characters are written
+	void setColor(ILI9486_COLOR color, ILI9486_COLOR background); // Change colors, whole text is redrawn on next setText
+	void invalidate(); // Redraw whole text on next setText, use after screen was drawn over
+	void clear(); // Fill cells of current text with background color
+
+	uint8_t getLength(); // Number of characters of current text
+
+private:
+	void drawCell(uint8_t i, uint8_t character); // Draw character cell with background in one burst
+
+	ILI9486 *display;
+	uint16_t x;
+	uint16_t y;
+	ILI9486::FontSize size;
+	ILI9486_COLOR color;
+	ILI9486_COLOR background;
+
+	uint8_t text[ILI9486_TEXTFIELD_LENGTH]; // Characters drawn on last render
+	uint8_t length; // Number of cells drawn on last render, kept when field is invalidated
+	bool valid; // Whether screen content matches text, false forces redrawing every cell
+};
@@ -0,0 +1,168 @@
+/*
+ILI9486TextLayout.cpp
+Implementation of ILI9486TextLayout class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486TextLayout.h"
+
+static const uint8_t ELLIPSIS[] = "...";
+
+ILI9486TextLayout::ILI9486TextLayout(ILI9486 *display, ILI9486::FontSize size):
+	display(display),
+	size(size),
+	charWidth(display->getCharWidth(size)),
+	charHeight(display->getCharHeight(size))
+{}
+
+uint16_t ILI9486TextLayout::measure(const uint8_t *str) {
+	uint16_t characters = 0;
+
+	while (*str != '\0') {
+		ILI9486::decodeUTF8(&str);
+		characters++;
+	}
+
+	return characters * this->charWidth;
+}
+
+uint16_t ILI9486TextLayout::measure(const uint8_t *str, uint16_t length) {
+	const uint8_t *end = str + length;
+	uint16_t characters = 0;
+
+	while (str < end && *str != '\0') {
+		ILI9486::decodeUTF8(&str);
+		characters++;
+	}
+
+	return characters * this->charWidth;
+}
+
+uint8_t ILI9486TextLayout::wrap(const uint8_t *str, uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, Alignment alignment, bool ellipsis, ILI9486TextLine *lines, uint8_t maxLines) {
+	uint16_t maxCharacters = (xEnd - xStart) / this->charWidth;
+	uint16_t boxLines = (yEnd - yStart) / this->charHeight;
+	if (boxLines < maxLines) { maxLines = boxLines; }
+	if (maxCharacters == 0) { return 0; }
+
+	uint8_t count = 0;
+	uint16_t characters = 0; // Characters of last line
+
+	while (*str != '\0' && count < maxLines) {
+		const uint8_t *start = str;
+		const uint8_t *lastSpace = NULL;
+		uint16_t lastSpaceCharacters = 0;
+		characters = 0;
+
+		// Walk until end of line, end of string or box edge
+		while (*str != '\0' && *str != '\n') {
+			if (*str == ' ') {
+				lastSpace = str;
+				lastSpaceCharacters = characters;
+			}
+
+			if (characters == maxCharacters) { break; }
+
+			ILI9486::decodeUTF8(&str);
+			characters++;
+		}
+
+		const uint8_t *end = str;
+		if (*str == '\n') {
+			str++;
+		} else if (*str != '\0' && lastSpace != NULL) {
+			// Break at last space, word which didn't fit goes to next line
+			end = lastSpace;
+			characters = lastSpaceCharacters;
+			str = lastSpace;
+		}
+
+		// Spaces at wrap point are not drawn
+		while (*str == ' ') { str++; }
+
+		uint16_t y = yEnd - count * this->charHeight - (this->charHeight / 2) - 1;
+		lines[count].str = start;
+		lines[count].length = end - start;
+		lines[count].ellipsis = false;
+		this->placeLine(&lines[count], characters, xStart, xEnd, y, alignment);
+		count++;
+	}
+
+	// Text doesn't fit, last line is shortened to make place for ellipsis, box narrower than ellipsis gets only cut text
+	if (ellipsis && count > 0 && *str != '\0' && maxCharacters >= 3) {
+		ILI9486TextLine *last = &lines[count - 1];
+		uint16_t limit = maxCharacters - 3;
+		const uint8_t *p = last->str;
+		const uint8_t *end = last->str + last->length;
+		characters = 0;
+
+		while (p < end && characters < limit) {
+			ILI9486::decodeUTF8(&p);
+			characters++;
+		}
+
+		last->length = p - last->str;
+		last->ellipsis = true;
+		this->placeLine(last, characters + 3, xStart, xEnd, last->y, alignment);
+	}
+
+	return count;
+}
+
+void ILI9486TextLayout::draw(const ILI9486TextLine *lines, uint8_t count, ILI9486_COLOR color, ILI9486_COLOR background) {
+	for (uint8_t i = 0; i < count; i++) {
+		if (!lines[i].ellipsis) {
+			this->display->drawText(lines[i].x, lines[i].y, lines[i].str, lines[i].length, this->size, color, background);
+			continue;
+		}
+
+		// Line is copied together with ellipsis, so it is written in one burst too, characters are stored
+		// as characters of cell font, which take one byte each
+		uint8_t text[ILI9486_TEXTLAYOUT_COLUMNS];
+		const uint8_t *p = lines[i].str;
+		const uint8_t *end = lines[i].str + lines[i].length;
+		uint16_t n = 0;
+
+		while (p < end && *p != '\0' && n < ILI9486_TEXTLAYOUT_COLUMNS - 3) {
+			text[n++] = ILI9486::cellChar(ILI9486::decodeUTF8(&p));
+		}
+
+		memcpy(text + n, ELLIPSIS, 3);
+		this->display->drawText(lines[i].x, lines[i].y, text, n + 3, this->size, color, background);
+	}
+}
+
+uint8_t ILI9486TextLayout::drawText(const uint8_t *str, uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, Alignment alignment, bool ellipsis, ILI9486_COLOR color, ILI9486_COLOR background) {
+	ILI9486TextLine lines[ILI9486_TEXTLAYOUT_LINES];
+
+	uint8_t count = this->wrap(str, xStart, yStart, xEnd, yEnd, alignment, ellipsis, lines, ILI9486_TEXTLAYOUT_LINES);
+	this->draw(lines, count, color, background);
+
+	return count;
+}
+
+void ILI9486TextLayout::placeLine(ILI9486TextLine *line, uint16_t characters, uint16_t xStart, uint16_t xEnd, uint16_t y, Alignment alignment) {
+	line->width = characters * this->charWidth;
+	line->y = y;
+
+	uint16_t left = xStart;
+	switch (alignment) {
+		case LEFT: break;
+		case CENTER: left += ((xEnd - xStart) - line->width) / 2; break;
+		case RIGHT: left = xEnd - line->width; break;
+	}
+
+	// Lines keep drawString convention, x is center of first character
+	line->x = left + (this->charWidth / 2);
+}
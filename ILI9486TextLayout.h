@@ -0,0 +1,67 @@
+/*
+ILI9486TextLayout.h
+Class ILI9486TextLayout measures text, wraps it into rectangular box
+and draws it aligned, without heap allocation.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "ILI9486.h"
+
+// Maximum number of lines drawn by drawText, lines are kept on stack
+#define ILI9486_TEXTLAYOUT_LINES 16
+
+// Characters of line with ellipsis copied to stack, fits line of the smallest font (5 px wide) across long side
+#define ILI9486_TEXTLAYOUT_COLUMNS (ILI9486_LONG_SIDE / 5)
+
+// Single line of wrapped text
+struct ILI9486TextLine {
+	const uint8_t *str; // First character of line in wrapped string
+	uint16_t length; // Number of bytes of line
+	uint16_t x; // Center of first character, like in drawString
+	uint16_t y;
+	uint16_t width; // Width of line including ellipsis [px]
+	bool ellipsis; // Line is truncated, "..." is drawn after it
+};
+
+class ILI9486TextLayout {
+public:
+	enum Alignment {
+		LEFT,
+		CENTER,
+		RIGHT
+	};
+
+	ILI9486TextLayout(ILI9486 *display, ILI9486::FontSize size);
+
+	uint16_t measure(const uint8_t *str); // Width of string [px]
+	uint16_t measure(const uint8_t *str, uint16_t length); // Width of first length bytes of string [px]
+
+	// Wrap words of str into box, lines are stacked from yEnd towards yStart (direction in which character lines are drawn)
+	// Text which doesn't fit is cut, with ellipsis last line ends with "..."
+	// Returns number of lines written to lines array
+	uint8_t wrap(const uint8_t *str, uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, Alignment alignment, bool ellipsis, ILI9486TextLine *lines, uint8_t maxLines);
+	void draw(const ILI9486TextLine *lines, uint8_t count, ILI9486_COLOR color, ILI9486_COLOR background); // Every line is written in one burst
+	uint8_t drawText(const uint8_t *str, uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, Alignment alignment, bool ellipsis, ILI9486_COLOR color, ILI9486_COLOR background); // Wrap and draw, returns number of lines
+
+private:
+	void placeLine(ILI9486TextLine *line, uint16_t characters, uint16_t xStart, uint16_t xEnd, uint16_t y, Alignment alignment); // Set position and width of line
+
+	ILI9486 *display;
+	ILI9486::FontSize size;
+	uint16_t charWidth; // [px]
+	uint16_t charHeight; // [px]
+};
@@ -0,0 +1,44 @@
+/*
+aafont.h
+Anti-aliased font format used by ILI9486 class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#ifndef __AAFONT_H
+#define __AAFONT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Glyphs of characters ' ' to '~', every glyph is Width x Height cell like in sFONT
+// Every pixel is coverage value with Bpp bits (0 - background, max - foreground), most significant bits first
+// Every line starts on byte boundary, lines are stored from top to bottom
+// Tables are generated with tools/fontconvert.py
+typedef struct _tAAFont
+{
+  const uint8_t *table;
+  uint16_t Width;
+  uint16_t Height;
+  uint8_t Bpp; // Bits per pixel, 2 or 4
+} sAAFONT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AAFONT_H */
@@ -0,0 +1,75 @@
+/*
+pfont.h
+Proportional font format used by ILI9486 class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#ifndef __PFONT_H
+#define __PFONT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Metrics of single character, only inked box of character is stored in bitmap table
+typedef struct _tGlyph
+{
+  uint32_t offset; // Position of first bitmap byte in table
+  uint8_t width; // Inked box size [px]
+  uint8_t height;
+  uint8_t xAdvance; // Distance to next character pen position [px]
+  int8_t xOffset; // Distance from pen position to left edge of box [px]
+  int8_t yOffset; // Distance from top of line to top edge of box [px]
+} sGLYPH;
+
+// Distance correction between two characters, pairs are sorted by left then right glyph index
+typedef struct _tKernPair
+{
+  uint16_t left; // Glyph index
+  uint16_t right;
+  int8_t adjust; // Added to xAdvance of left glyph [px]
+} sKERNPAIR;
+
+// Bitmap compression
+#define PFONT_RAW 0 // Bitmap of every glyph has width * height values with Bpp bits, most significant bits first
+#define PFONT_RLE 1 // Run-length encoded, 1 bit fonts - 4 bit runs of alternating background and foreground pixels, starting with background
+                    // 2 and 4 bit fonts - byte per run, value in Bpp most significant bits, run length - 1 in remaining bits
+
+// Bitmap of every glyph starts on byte boundary, lines are stored from bottom to top, which is the order they are written to display window
+// Runs of compressed bitmaps can cross lines, so bitmap is decoded while it is written
+// Font covers either every character from First to Last, or any set of Unicode characters listed in sorted codepoints index
+// Glyphs, codepoints, kerning pairs and bitmaps are stored in FLASH memory, tables are generated with tools/fontconvert.py
+typedef struct _tPFont
+{
+  const uint8_t *table;
+  const sGLYPH *glyphs; // Glyphs in order of characters
+  const sKERNPAIR *kerning; // NULL if font has no kerning
+  uint16_t kerningCount;
+  uint16_t First; // Lowest codepoint
+  uint16_t Last; // Highest codepoint
+  uint8_t Height; // Line height [px]
+  uint8_t Bpp; // Bits per pixel, 1, 2 or 4
+  const uint16_t *codepoints; // Sorted codepoint of every glyph, NULL if font covers every character from First to Last
+  uint16_t glyphCount; // Number of codepoints
+  uint8_t Compression; // PFONT_RAW or PFONT_RLE
+} sPFONT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PFONT_H */
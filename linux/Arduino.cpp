@@ -0,0 +1,88 @@
+/*
+Arduino.cpp
+Implementation of Arduino core functions for Linux builds.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "Arduino.h"
+#include "SPI.h"
+
+#include <time.h>
+
+static uint64_t startTime = 0; // [us]
+
+static uint64_t now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+	ILI9486Bus *bus = SPI.getBus();
+	if (bus == NULL || pin == bus->getChipSelect()) { return; }
+
+	bus->setPinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+	ILI9486Bus *bus = SPI.getBus();
+	if (bus == NULL) { return; }
+
+	if (pin == bus->getChipSelect()) {
+		SPI.select(value == LOW);
+		return;
+	}
+
+	// Queued bytes must be sent with previous pin state, GPIO can't change in the middle of SPI message,
+	// so commands and their parameters always end up in separate messages
+	if (bus->getPin(pin) != (value ? HIGH : LOW)) {
+		SPI.flush();
+		bus->setPin(pin, value);
+	}
+}
+
+void analogWrite(uint8_t pin, int value) {
+	digitalWrite(pin, value > 0 ? HIGH : LOW);
+}
+
+void delay(unsigned long ms) {
+	SPI.flush();
+
+	struct timespec ts;
+	ts.tv_sec = ms / 1000;
+	ts.tv_nsec = (ms % 1000) * 1000000L;
+	nanosleep(&ts, NULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+	SPI.flush();
+
+	struct timespec ts;
+	ts.tv_sec = us / 1000000;
+	ts.tv_nsec = (us % 1000000) * 1000L;
+	nanosleep(&ts, NULL);
+}
+
+unsigned long millis() {
+	return micros() / 1000;
+}
+
+unsigned long micros() {
+	if (startTime == 0) {
+		startTime = now();
+	}
+
+	return now() - startTime;
+}
@@ -0,0 +1,53 @@
+/*
+ILI9486Bus.cpp
+Implementation of ILI9486Bus class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486Bus.h"
+
+#include <string.h>
+
+ILI9486Bus::ILI9486Bus(uint8_t chipSelect, uint8_t dataCommand, uint32_t speed):
+	chipSelect(chipSelect),
+	dataCommand(dataCommand),
+	speed(speed)
+{
+	memset(this->pins, 0xFF, sizeof(this->pins));
+}
+
+void ILI9486Bus::setPin(uint8_t pin, uint8_t value) {
+	value = value ? 1 : 0;
+	if (this->pins[pin] == value) { return; }
+
+	this->pins[pin] = value;
+	this->writePin(pin, value);
+}
+
+uint8_t ILI9486Bus::getPin(uint8_t pin) {
+	return this->pins[pin];
+}
+
+uint8_t ILI9486Bus::getChipSelect() {
+	return this->chipSelect;
+}
+
+uint8_t ILI9486Bus::getDataCommand() {
+	return this->dataCommand;
+}
+
+uint32_t ILI9486Bus::getSpeed() {
+	return this->speed;
+}
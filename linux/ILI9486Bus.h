@@ -0,0 +1,55 @@
+/*
+ILI9486Bus.h
+Class ILI9486Bus represent SPI device and GPIO lines used by ILI9486 library on Linux.
+Messages have the same form as messages of SPI_IOC_MESSAGE ioctl of spidev driver.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <linux/spi/spidev.h>
+
+// Number of GPIO lines which can be used as pins, pin number is line offset on GPIO chip
+#define ILI9486_BUS_PINS 256
+
+class ILI9486Bus {
+public:
+	// Chip select is driven by SPI controller, so its pin is not GPIO line, it only marks transaction boundaries
+	// Data / command pin tells reads from writes, 8 bit transfers with data / command pin high are reads
+	ILI9486Bus(uint8_t chipSelect, uint8_t dataCommand, uint32_t speed);
+	virtual ~ILI9486Bus() {}
+
+	virtual bool message(struct spi_ioc_transfer *transfers, uint32_t count) = 0; // Execute transfers, cs_change of transfer deselects chip after it (after last transfer it keeps chip selected)
+	virtual uint32_t getMessageSize() = 0; // Maximum number of bytes in one message
+
+	virtual void setPinMode(uint8_t pin, uint8_t mode) = 0;
+	virtual void writePin(uint8_t pin, uint8_t value) = 0;
+
+	void setPin(uint8_t pin, uint8_t value); // Write pin if its value changes
+	uint8_t getPin(uint8_t pin); // Last value written to pin
+
+	uint8_t getChipSelect();
+	uint8_t getDataCommand();
+	uint32_t getSpeed(); // SPI clock [Hz]
+
+protected:
+	uint8_t chipSelect;
+	uint8_t dataCommand;
+	uint32_t speed;
+
+	uint8_t pins[ILI9486_BUS_PINS]; // Last written values, 0xFF if pin was not written yet
+};
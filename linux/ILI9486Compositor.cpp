@@ -0,0 +1,614 @@
+/*
+ILI9486Compositor.cpp
+Implementation of ILI9486Compositor and ILI9486Surface classes.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486Compositor.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// Pixels start at cache line boundary
+#define ILI9486_SURFACE_ALIGN 64
+
+static bool address(const char *path, struct sockaddr_un *result) {
+	memset(result, 0, sizeof(*result));
+	result->sun_family = AF_UNIX;
+
+	if (strlen(path) >= sizeof(result->sun_path)) {
+		fprintf(stderr, "%s: socket path is too long\n", path);
+		return false;
+	}
+
+	strcpy(result->sun_path, path);
+	return true;
+}
+
+ILI9486Compositor::ILI9486Compositor(ILI9486 *display, const char *path, ILI9486_COLOR background):
+	display(display),
+	background(background),
+	path(path),
+	listener(-1),
+	running(true),
+	count(0),
+	areaCount(0),
+	pending(false)
+{
+	memset(&this->stats, 0, sizeof(this->stats));
+	this->line = new ILI9486_COLOR[display->getWidth()];
+
+	struct sockaddr_un socketAddress;
+	if (!address(path, &socketAddress)) { return; }
+
+	// Socket file left by previous compositor would make bind fail
+	unlink(path);
+
+	this->listener = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (this->listener < 0 || bind(this->listener, (struct sockaddr*)&socketAddress, sizeof(socketAddress)) < 0 || listen(this->listener, ILI9486_COMPOSITOR_CLIENTS) < 0) {
+		perror(path);
+		if (this->listener >= 0) {
+			close(this->listener);
+			this->listener = -1;
+		}
+		return;
+	}
+
+	// Background is drawn on first update
+	this->damage(0, 0, display->getWidth(), display->getHeight());
+}
+
+ILI9486Compositor::~ILI9486Compositor() {
+	while (this->count > 0) {
+		this->remove(&this->clients[this->count - 1]);
+	}
+
+	if (this->listener >= 0) {
+		close(this->listener);
+		unlink(this->path);
+	}
+
+	delete[] this->line;
+}
+
+bool ILI9486Compositor::isOpen() {
+	return this->listener >= 0;
+}
+
+bool ILI9486Compositor::update(int timeout) {
+	struct pollfd descriptors[1 + ILI9486_COMPOSITOR_CLIENTS];
+	descriptors[0].fd = this->listener;
+	descriptors[0].events = POLLIN;
+
+	for (uint8_t i = 0; i < this->count; i++) {
+		descriptors[i + 1].fd = this->clients[i].socket;
+		descriptors[i + 1].events = POLLIN;
+	}
+
+	// Pending damage is drawn without waiting
+	if (poll(descriptors, this->count + 1, this->areaCount > 0 || this->pending ? 0 : timeout) > 0) {
+		// Removed client is replaced by last one, which was already handled
+		for (int i = this->count - 1; i >= 0; i--) {
+			if (descriptors[i + 1].revents != 0 && !this->receive(&this->clients[i])) {
+				this->remove(&this->clients[i]);
+			}
+		}
+
+		if (descriptors[0].revents & POLLIN) {
+			this->accept();
+		}
+	}
+
+	this->pending = false;
+	for (uint8_t i = 0; i < this->count; i++) {
+		if (!this->collect(&this->clients[i])) {
+			this->pending = true;
+		}
+	}
+
+	if (this->areaCount == 0) { return false; }
+
+	unsigned long start = micros();
+
+	for (uint8_t i = 0; i < this->areaCount; i++) {
+		Area *area = &this->areas[i];
+		this->composite(area->xStart, area->yStart, area->xEnd, area->yEnd);
+		this->stats.pixels += (uint32_t)(area->xEnd - area->xStart) * (area->yEnd - area->yStart);
+	}
+
+	SPI.flush();
+
+	this->stats.updates++;
+	this->stats.rectangles += this->areaCount;
+	this->stats.compositeTime = micros() - start;
+	this->areaCount = 0;
+	return true;
+}
+
+void ILI9486Compositor::run() {
+	this->running = true;
+
+	while (this->running) {
+		this->update(100);
+	}
+}
+
+void ILI9486Compositor::stop() {
+	this->running = false;
+}
+
+void ILI9486Compositor::getStats(ILI9486CompositorStats *stats) {
+	*stats = this->stats;
+	stats->clients = this->count;
+}
+
+void ILI9486Compositor::accept() {
+	int socket = ::accept4(this->listener, NULL, NULL, SOCK_CLOEXEC);
+	if (socket < 0) { return; }
+
+	if (this->count == ILI9486_COMPOSITOR_CLIENTS) {
+		close(socket);
+		return;
+	}
+
+	Client *client = &this->clients[this->count++];
+	memset(client, 0, sizeof(*client));
+	client->socket = socket;
+}
+
+bool ILI9486Compositor::receive(Client *client) {
+	ILI9486CompositorRequest request;
+	ssize_t length = recv(client->socket, &request, sizeof(request), MSG_DONTWAIT);
+
+	if (length < 0) { return errno == EAGAIN || errno == EINTR; }
+	if (length != sizeof(request)) { return false; }
+
+	if (request.type == DAMAGED) { return true; }
+
+	ILI9486CompositorReply reply;
+	reply.status = 0;
+
+	if (request.type == CREATE) {
+		if (client->memory != NULL) {
+			reply.status = EEXIST;
+		} else {
+			// Reply carrying memory is sent by create
+			this->create(client, &request);
+			return true;
+		}
+	} else if (client->memory == NULL) {
+		reply.status = ENOENT;
+	} else {
+		// Area is damaged both before and after change, so uncovered parts are redrawn
+		this->damageSurface(client, 0, 0, client->width, client->height);
+
+		if (request.type == MOVE) {
+			client->x = request.x;
+			client->y = request.y;
+		} else if (request.type == RESTACK) {
+			client->z = request.z;
+		} else if (request.type == SHOW) {
+			client->visible = request.visible != 0;
+		} else {
+			reply.status = EINVAL;
+		}
+
+		this->damageSurface(client, 0, 0, client->width, client->height);
+	}
+
+	return send(client->socket, &reply, sizeof(reply), MSG_NOSIGNAL) == sizeof(reply);
+}
+
+void ILI9486Compositor::create(Client *client, const ILI9486CompositorRequest *request) {
+	ILI9486CompositorReply reply;
+	reply.status = 0;
+
+	uint32_t offset = (sizeof(ILI9486SurfaceMemory) + ILI9486_SURFACE_ALIGN - 1) & ~(ILI9486_SURFACE_ALIGN - 1);
+	size_t size = offset + (size_t)request->width * request->height * sizeof(ILI9486_COLOR);
+
+	// Memory is anonymous, only compositor and client hold it, size is sealed, so client can't shrink it under mapping of compositor
+	int memory = -1;
+	if (request->width == 0 || request->height == 0 || request->width > ILI9486_LONG_SIDE || request->height > ILI9486_LONG_SIDE) {
+		reply.status = EINVAL;
+	} else if ((memory = memfd_create("ili9486-surface", MFD_CLOEXEC | MFD_ALLOW_SEALING)) < 0 || ftruncate(memory, size) < 0
+		|| fcntl(memory, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+		reply.status = errno;
+	} else {
+		void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, memory, 0);
+		if (mapping == MAP_FAILED) {
+			reply.status = errno;
+		} else {
+			client->memory = (ILI9486SurfaceMemory*)mapping;
+			client->size = size;
+			client->pixels = offset;
+			client->memory->width = request->width;
+			client->memory->height = request->height;
+			client->memory->pixels = offset;
+		}
+	}
+
+	// Descriptor of memory is passed as ancillary data
+	struct iovec data;
+	data.iov_base = &reply;
+	data.iov_len = sizeof(reply);
+
+	union {
+		struct cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(int))];
+	} control;
+
+	struct msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &data;
+	message.msg_iovlen = 1;
+
+	if (reply.status == 0) {
+		message.msg_control = control.buffer;
+		message.msg_controllen = sizeof(control.buffer);
+
+		struct cmsghdr *header = CMSG_FIRSTHDR(&message);
+		header->cmsg_level = SOL_SOCKET;
+		header->cmsg_type = SCM_RIGHTS;
+		header->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(header), &memory, sizeof(int));
+	}
+
+	sendmsg(client->socket, &message, MSG_NOSIGNAL);
+
+	if (memory >= 0) {
+		close(memory);
+	}
+
+	if (reply.status != 0) { return; }
+
+	client->x = request->x;
+	client->y = request->y;
+	client->z = request->z;
+	client->width = request->width;
+	client->height = request->height;
+	client->visible = request->visible != 0;
+
+	this->damageSurface(client, 0, 0, client->width, client->height);
+}
+
+void ILI9486Compositor::remove(Client *client) {
+	if (client->memory != NULL) {
+		this->damageSurface(client, 0, 0, client->width, client->height);
+		munmap(client->memory, client->size);
+	}
+
+	close(client->socket);
+	*client = this->clients[--this->count];
+}
+
+bool ILI9486Compositor::collect(Client *client) {
+	ILI9486SurfaceMemory *memory = client->memory;
+	if (memory == NULL) { return true; }
+
+	uint32_t head = memory->head;
+	uint32_t tail = __atomic_load_n(&memory->tail, __ATOMIC_SEQ_CST);
+
+	// Client doesn't wake compositor when it sees ring non empty, so tail is read again after head is published
+	// and rectangles put in meantime are taken too. Client filling ring all the time is drained in next update.
+	for (uint8_t pass = 0; pass < ILI9486_COMPOSITOR_RING; pass++) {
+		bool overflow = __atomic_exchange_n(&memory->overflow, 0, __ATOMIC_ACQ_REL) != 0;
+
+		// Client with full ring or broken counters gets whole surface redrawn
+		if (overflow || tail - head > ILI9486_COMPOSITOR_RING) {
+			if (client->visible) {
+				this->damageSurface(client, 0, 0, client->width, client->height);
+			}
+			head = tail;
+		}
+
+		for (; head != tail; head++) {
+			ILI9486DamageRect rect = memory->ring[head % ILI9486_COMPOSITOR_RING];
+			if (client->visible) {
+				this->damageSurface(client, rect.x, rect.y, rect.width, rect.height);
+			}
+		}
+
+		__atomic_store_n(&memory->head, head, __ATOMIC_SEQ_CST);
+
+		tail = __atomic_load_n(&memory->tail, __ATOMIC_SEQ_CST);
+		if (tail == head) { return true; }
+	}
+
+	return false;
+}
+
+void ILI9486Compositor::damageSurface(Client *client, int32_t x, int32_t y, int32_t width, int32_t height) {
+	// Rectangle is clipped to surface, then moved to screen coordinates
+	int32_t xEnd = x + width < client->width ? x + width : client->width;
+	int32_t yEnd = y + height < client->height ? y + height : client->height;
+
+	this->damage(client->x + x, client->y + y, client->x + xEnd, client->y + yEnd);
+}
+
+void ILI9486Compositor::damage(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd) {
+	// Clip to screen
+	if (xStart < 0) { xStart = 0; }
+	if (yStart < 0) { yStart = 0; }
+	if (xEnd > this->display->getWidth()) { xEnd = this->display->getWidth(); }
+	if (yEnd > this->display->getHeight()) { yEnd = this->display->getHeight(); }
+	if (xStart >= xEnd || yStart >= yEnd) { return; }
+
+	// Overlapping or touching areas are merged into their bounding box, which may touch others
+	for (uint8_t i = 0; i < this->areaCount;) {
+		Area *area = &this->areas[i];
+
+		if (xStart > area->xEnd || area->xStart > xEnd || yStart > area->yEnd || area->yStart > yEnd) {
+			i++;
+			continue;
+		}
+
+		if (area->xStart < xStart) { xStart = area->xStart; }
+		if (area->yStart < yStart) { yStart = area->yStart; }
+		if (area->xEnd > xEnd) { xEnd = area->xEnd; }
+		if (area->yEnd > yEnd) { yEnd = area->yEnd; }
+
+		*area = this->areas[--this->areaCount];
+		i = 0;
+	}
+
+	// Too many separate areas are replaced by their bounding box
+	if (this->areaCount == ILI9486_COMPOSITOR_DAMAGE) {
+		for (uint8_t i = 0; i < this->areaCount; i++) {
+			Area *area = &this->areas[i];
+			if (area->xStart < xStart) { xStart = area->xStart; }
+			if (area->yStart < yStart) { yStart = area->yStart; }
+			if (area->xEnd > xEnd) { xEnd = area->xEnd; }
+			if (area->yEnd > yEnd) { yEnd = area->yEnd; }
+		}
+		this->areaCount = 0;
+	}
+
+	Area *area = &this->areas[this->areaCount++];
+	area->xStart = xStart;
+	area->yStart = yStart;
+	area->xEnd = xEnd;
+	area->yEnd = yEnd;
+}
+
+void ILI9486Compositor::composite(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+	// Visible surfaces ordered by z, surfaces with equal z keep order of creation
+	Client *order[ILI9486_COMPOSITOR_CLIENTS];
+	uint8_t n = 0;
+
+	for (uint8_t i = 0; i < this->count; i++) {
+		Client *client = &this->clients[i];
+		if (client->memory == NULL || !client->visible) { continue; }
+
+		uint8_t j = n++;
+		while (j > 0 && order[j - 1]->z > client->z) {
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = client;
+	}
+
+	uint16_t width = xEnd - xStart;
+	this->display->openWindow(xStart, yStart, xEnd, yEnd);
+
+	// Rows are painted from the lowest surface to the highest one
+	for (uint16_t y = yStart; y < yEnd; y++) {
+		for (uint16_t i = 0; i < width; i++) {
+			this->line[i] = this->background;
+		}
+
+		for (uint8_t i = 0; i < n; i++) {
+			Client *client = order[i];
+			if (y < client->y || y >= client->y + client->height) { continue; }
+
+			int32_t left = client->x > xStart ? client->x : xStart;
+			int32_t right = client->x + client->width < xEnd ? client->x + client->width : xEnd;
+			if (left >= right) { continue; }
+
+			const ILI9486_COLOR *pixels = (const ILI9486_COLOR*)((const uint8_t*)client->memory + client->pixels);
+			memcpy(this->line + (left - xStart), pixels + (uint32_t)(y - client->y) * client->width + (left - client->x), (right - left) * sizeof(ILI9486_COLOR));
+		}
+
+		this->display->writeBuffer(this->line, width);
+	}
+}
+
+ILI9486Surface::ILI9486Surface():
+	socket(-1),
+	memory(NULL),
+	size(0),
+	width(0),
+	height(0)
+{}
+
+ILI9486Surface::~ILI9486Surface() {
+	this->disconnect();
+}
+
+bool ILI9486Surface::connect(const char *path, int16_t x, int16_t y, uint16_t width, uint16_t height, int16_t z, bool visible) {
+	this->disconnect();
+
+	struct sockaddr_un socketAddress;
+	if (!address(path, &socketAddress)) { return false; }
+
+	this->socket = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (this->socket < 0 || ::connect(this->socket, (struct sockaddr*)&socketAddress, sizeof(socketAddress)) < 0) {
+		perror(path);
+		this->disconnect();
+		return false;
+	}
+
+	ILI9486CompositorRequest request;
+	memset(&request, 0, sizeof(request));
+	request.type = ILI9486Compositor::CREATE;
+	request.visible = visible;
+	request.x = x;
+	request.y = y;
+	request.z = z;
+	request.width = width;
+	request.height = height;
+
+	if (send(this->socket, &request, sizeof(request), MSG_NOSIGNAL) != sizeof(request)) {
+		this->disconnect();
+		return false;
+	}
+
+	// Reply carries descriptor of surface memory
+	ILI9486CompositorReply reply;
+	struct iovec data;
+	data.iov_base = &reply;
+	data.iov_len = sizeof(reply);
+
+	union {
+		struct cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(int))];
+	} control;
+
+	struct msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &data;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+
+	int memory = -1;
+	if (recvmsg(this->socket, &message, MSG_CMSG_CLOEXEC) == sizeof(reply) && reply.status == 0) {
+		struct cmsghdr *header = CMSG_FIRSTHDR(&message);
+		if (header != NULL && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+			memcpy(&memory, CMSG_DATA(header), sizeof(int));
+		}
+	} else if (reply.status != 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(reply.status));
+	}
+
+	struct stat info;
+	if (memory < 0 || fstat(memory, &info) < 0) {
+		if (memory >= 0) {
+			close(memory);
+		}
+		this->disconnect();
+		return false;
+	}
+
+	void *mapping = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, memory, 0);
+	close(memory);
+
+	if (mapping == MAP_FAILED) {
+		this->disconnect();
+		return false;
+	}
+
+	this->memory = (ILI9486SurfaceMemory*)mapping;
+	this->size = info.st_size;
+	this->width = this->memory->width;
+	this->height = this->memory->height;
+	return true;
+}
+
+void ILI9486Surface::disconnect() {
+	if (this->memory != NULL) {
+		munmap(this->memory, this->size);
+		this->memory = NULL;
+	}
+
+	if (this->socket >= 0) {
+		close(this->socket);
+		this->socket = -1;
+	}
+}
+
+ILI9486_COLOR *ILI9486Surface::getPixels() {
+	if (this->memory == NULL) { return NULL; }
+	return (ILI9486_COLOR*)((uint8_t*)this->memory + this->memory->pixels);
+}
+
+uint16_t ILI9486Surface::getWidth() {
+	return this->width;
+}
+
+uint16_t ILI9486Surface::getHeight() {
+	return this->height;
+}
+
+void ILI9486Surface::damage(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	if (this->memory == NULL) { return; }
+
+	uint32_t tail = this->memory->tail;
+	uint32_t head = __atomic_load_n(&this->memory->head, __ATOMIC_ACQUIRE);
+
+	// Pixels drawn before become visible to compositor together with new tail
+	if (tail - head >= ILI9486_COMPOSITOR_RING) {
+		__atomic_store_n(&this->memory->overflow, 1, __ATOMIC_RELEASE);
+	} else {
+		ILI9486DamageRect *rect = &this->memory->ring[tail % ILI9486_COMPOSITOR_RING];
+		rect->x = x;
+		rect->y = y;
+		rect->width = width;
+		rect->height = height;
+		__atomic_store_n(&this->memory->tail, tail + 1, __ATOMIC_SEQ_CST);
+
+		// Head is read after tail is published, when ring wasn't empty, compositor reads tail again after it publishes
+		// head and takes this rectangle, so only rectangle put into empty ring has to wake it
+		head = __atomic_load_n(&this->memory->head, __ATOMIC_SEQ_CST);
+		if (tail != head) { return; }
+	}
+
+	ILI9486CompositorRequest request;
+	memset(&request, 0, sizeof(request));
+	request.type = ILI9486Compositor::DAMAGED;
+	send(this->socket, &request, sizeof(request), MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+void ILI9486Surface::damage() {
+	this->damage(0, 0, this->width, this->height);
+}
+
+bool ILI9486Surface::move(int16_t x, int16_t y) {
+	return this->request(ILI9486Compositor::MOVE, x, y, 0, false);
+}
+
+bool ILI9486Surface::restack(int16_t z) {
+	return this->request(ILI9486Compositor::RESTACK, 0, 0, z, false);
+}
+
+bool ILI9486Surface::show(bool visible) {
+	return this->request(ILI9486Compositor::SHOW, 0, 0, 0, visible);
+}
+
+bool ILI9486Surface::request(uint8_t type, int16_t x, int16_t y, int16_t z, bool visible) {
+	if (this->socket < 0) { return false; }
+
+	ILI9486CompositorRequest request;
+	memset(&request, 0, sizeof(request));
+	request.type = type;
+	request.visible = visible;
+	request.x = x;
+	request.y = y;
+	request.z = z;
+
+	ILI9486CompositorReply reply;
+	if (send(this->socket, &request, sizeof(request), MSG_NOSIGNAL) != sizeof(request) || recv(this->socket, &reply, sizeof(reply), 0) != sizeof(reply)) {
+		return false;
+	}
+
+	return reply.status == 0;
+}
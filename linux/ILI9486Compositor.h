@@ -0,0 +1,172 @@
+/*
+ILI9486Compositor.h
+Class ILI9486Compositor owns display and composites surfaces of client processes.
+Every client gets RGB565 surface in shared memory with position and z-order,
+damaged rectangles are passed through lock-free ring in the same memory and
+only they are redrawn. Clients are controlled through Unix domain socket,
+class ILI9486Surface is the client side.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <stddef.h>
+
+#include <ILI9486.h>
+
+#define ILI9486_COMPOSITOR_CLIENTS 16 // Maximum number of connected clients
+#define ILI9486_COMPOSITOR_RING 64 // Damage rectangles queued by one client
+#define ILI9486_COMPOSITOR_DAMAGE 64 // Merged screen rectangles, more damage redraws whole screen
+
+// Rectangle in surface coordinates, exclusive end is x + width, y + height
+struct ILI9486DamageRect {
+	uint16_t x;
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+};
+
+// Beginning of shared memory of surface, pixels follow at ILI9486SurfaceMemory::pixels offset
+// Size fields are written by compositor when surface is created, it doesn't read them later
+struct ILI9486SurfaceMemory {
+	uint32_t head; // Count of rectangles taken from ring, written only by compositor
+	uint32_t tail; // Count of rectangles put into ring, written only by client
+	uint32_t overflow; // Set by client when ring was full, compositor redraws whole surface
+	uint16_t width;
+	uint16_t height;
+	uint32_t pixels; // Offset of pixels from beginning of memory, rows are packed
+	ILI9486DamageRect ring[ILI9486_COMPOSITOR_RING];
+};
+
+// Control messages sent by client through socket
+struct ILI9486CompositorRequest {
+	uint8_t type;
+	uint8_t visible;
+	int16_t x; // Position of surface on display, may be partly outside
+	int16_t y;
+	int16_t z; // Surfaces with higher z cover lower ones
+	uint16_t width;
+	uint16_t height;
+};
+
+// Reply to every request except DAMAGED, reply to CREATE carries memory descriptor
+struct ILI9486CompositorReply {
+	int32_t status; // 0 or errno value
+};
+
+// Counters since start
+struct ILI9486CompositorStats {
+	uint32_t clients; // Connected clients
+	uint32_t updates; // Updates which sent anything
+	uint32_t rectangles; // Sent screen rectangles
+	uint64_t pixels; // Sent pixels
+	uint32_t compositeTime; // Time of last update which sent anything [us]
+};
+
+class ILI9486Compositor {
+public:
+	enum RequestType {
+		CREATE, // Create surface of given size, position, z and visibility
+		MOVE, // Change position
+		RESTACK, // Change z
+		SHOW, // Change visibility
+		DAMAGED // Ring became non empty, no reply
+	};
+
+	ILI9486Compositor(ILI9486 *display, const char *path, ILI9486_COLOR background = ILI9486_BLACK); // Listen on socket path, existing socket file is replaced
+	~ILI9486Compositor();
+
+	bool isOpen();
+	bool update(int timeout); // Wait up to timeout ms for requests, then composite damage, returns whether anything was sent
+	void run(); // Update until stop is called
+	void stop(); // Can be called from signal handler
+
+	void getStats(ILI9486CompositorStats *stats);
+
+private:
+	struct Client {
+		int socket;
+		ILI9486SurfaceMemory *memory; // NULL until surface is created
+		size_t size;
+		uint32_t pixels; // Offset of pixels, header in shared memory is writable by client and is not trusted
+		int16_t x;
+		int16_t y;
+		int16_t z;
+		uint16_t width;
+		uint16_t height;
+		bool visible;
+	};
+
+	void accept();
+	bool receive(Client *client); // Handle request, returns false when client disconnected
+	void create(Client *client, const ILI9486CompositorRequest *request);
+	void remove(Client *client);
+	bool collect(Client *client); // Take rectangles from ring of client, returns false when client kept filling it and rest is left for next update
+	void damageSurface(Client *client, int32_t x, int32_t y, int32_t width, int32_t height); // Damage area given in surface coordinates
+	void damage(int32_t xStart, int32_t yStart, int32_t xEnd, int32_t yEnd); // Add screen rectangle, overlapping ones are merged
+	void composite(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd);
+
+	ILI9486 *display;
+	ILI9486_COLOR background;
+	const char *path;
+	int listener;
+	volatile bool running;
+
+	Client clients[ILI9486_COMPOSITOR_CLIENTS];
+	uint8_t count;
+
+	// Pending damage in screen coordinates, exclusive ends
+	struct Area {
+		uint16_t xStart;
+		uint16_t yStart;
+		uint16_t xEnd;
+		uint16_t yEnd;
+	};
+
+	Area areas[ILI9486_COMPOSITOR_DAMAGE];
+	uint8_t areaCount;
+	bool pending; // Ring was not drained, next update doesn't wait
+	ILI9486_COLOR *line; // Composited row
+
+	ILI9486CompositorStats stats;
+};
+
+class ILI9486Surface {
+public:
+	ILI9486Surface();
+	~ILI9486Surface();
+
+	bool connect(const char *path, int16_t x, int16_t y, uint16_t width, uint16_t height, int16_t z = 0, bool visible = true); // Create surface in compositor listening on path
+	void disconnect(); // Surface disappears from display
+
+	ILI9486_COLOR *getPixels(); // Rows are packed, draw them before submitting damage
+	uint16_t getWidth();
+	uint16_t getHeight();
+
+	void damage(uint16_t x, uint16_t y, uint16_t width, uint16_t height); // Mark area of surface for redraw
+	void damage(); // Mark whole surface for redraw
+	bool move(int16_t x, int16_t y);
+	bool restack(int16_t z);
+	bool show(bool visible);
+
+private:
+	bool request(uint8_t type, int16_t x, int16_t y, int16_t z, bool visible); // Send control message and wait for reply
+
+	int socket;
+	ILI9486SurfaceMemory *memory;
+	size_t size;
+	uint16_t width;
+	uint16_t height;
+};
@@ -0,0 +1,330 @@
+/*
+ILI9486LoopbackBus.cpp
+Implementation of ILI9486LoopbackBus class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486LoopbackBus.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define GRAM_BYTES (ILI9486_LOOPBACK_COLUMNS * ILI9486_LOOPBACK_PAGES * sizeof(uint16_t))
+
+static uint64_t monotonic() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+ILI9486LoopbackBus::ILI9486LoopbackBus(uint8_t chipSelect, uint8_t dataCommand, uint32_t speed, const char *path):
+	ILI9486Bus(chipSelect, dataCommand, speed),
+	gram(NULL),
+	file(-1),
+	code(0),
+	parameters(0),
+	high(0),
+	half(false),
+	columnStart(0),
+	columnEnd(ILI9486_LOOPBACK_COLUMNS - 1),
+	pageStart(0),
+	pageEnd(ILI9486_LOOPBACK_PAGES - 1),
+	column(0),
+	page(0),
+	memoryAccess(0),
+	readIndex(0),
+	clock(0)
+{
+	void *memory = MAP_FAILED;
+
+	if (path != NULL) {
+		this->file = open(path, O_RDWR | O_CREAT, 0644);
+		if (this->file < 0 || ftruncate(this->file, GRAM_BYTES) < 0) {
+			perror(path);
+		} else {
+			memory = mmap(NULL, GRAM_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, this->file, 0);
+		}
+	}
+
+	if (memory == MAP_FAILED) {
+		memory = mmap(NULL, GRAM_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	}
+
+	this->gram = (uint16_t*)memory;
+	this->resetCounters();
+}
+
+ILI9486LoopbackBus::~ILI9486LoopbackBus() {
+	munmap(this->gram, GRAM_BYTES);
+
+	if (this->file >= 0) {
+		close(this->file);
+	}
+}
+
+bool ILI9486LoopbackBus::message(struct spi_ioc_transfer *transfers, uint32_t count) {
+	bool command = this->getPin(this->dataCommand) == 0;
+	uint32_t length = 0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const uint8_t *tx = (const uint8_t*)(uintptr_t)transfers[i].tx_buf;
+		uint8_t *rx = (uint8_t*)(uintptr_t)transfers[i].rx_buf;
+
+		for (uint32_t j = 0; j < transfers[i].len; j++) {
+			uint8_t value = tx != NULL ? tx[j] : 0;
+			uint8_t received = 0;
+
+			if (command) {
+				this->command(value);
+			} else {
+				received = this->data(value);
+			}
+
+			if (rx != NULL) {
+				rx[j] = received;
+			}
+		}
+
+		length += transfers[i].len;
+
+		// cs_change deselects chip between transfers, but keeps it selected after the last one
+		if ((i + 1 < count) == (transfers[i].cs_change != 0)) {
+			this->deselect();
+		}
+	}
+
+	this->messages++;
+	this->transfers += count;
+	this->bytes += length;
+	this->wait(length);
+
+	return true;
+}
+
+uint32_t ILI9486LoopbackBus::getMessageSize() {
+	return ILI9486_LOOPBACK_MESSAGE;
+}
+
+void ILI9486LoopbackBus::setPinMode(uint8_t pin, uint8_t mode) {}
+
+void ILI9486LoopbackBus::writePin(uint8_t pin, uint8_t value) {}
+
+const uint16_t *ILI9486LoopbackBus::getGRAM() {
+	return this->gram;
+}
+
+uint16_t ILI9486LoopbackBus::getPixel(uint16_t column, uint16_t page) {
+	return this->gram[(uint32_t)page * ILI9486_LOOPBACK_COLUMNS + column];
+}
+
+uint32_t ILI9486LoopbackBus::getMessages() {
+	return this->messages;
+}
+
+uint32_t ILI9486LoopbackBus::getTransfers() {
+	return this->transfers;
+}
+
+uint64_t ILI9486LoopbackBus::getBytes() {
+	return this->bytes;
+}
+
+uint64_t ILI9486LoopbackBus::getPixels() {
+	return this->pixels;
+}
+
+uint32_t ILI9486LoopbackBus::getWindows() {
+	return this->windows;
+}
+
+void ILI9486LoopbackBus::resetCounters() {
+	this->messages = 0;
+	this->transfers = 0;
+	this->bytes = 0;
+	this->pixels = 0;
+	this->windows = 0;
+}
+
+void ILI9486LoopbackBus::deselect() {
+	this->half = false;
+}
+
+void ILI9486LoopbackBus::command(uint8_t code) {
+	this->code = code;
+	this->parameters = 0;
+	this->half = false;
+	this->readIndex = 0;
+
+	switch (code) {
+	case 0x2C:
+		this->windows++;
+		// Fall through
+	case 0x2E:
+		this->column = this->columnStart;
+		this->page = this->pageStart;
+		break;
+	}
+}
+
+uint8_t ILI9486LoopbackBus::data(uint8_t value) {
+	if (this->isRead(this->code)) {
+		// First byte of every read is dummy
+		uint32_t index = this->readIndex++;
+		if (index == 0) { return 0; }
+
+		if (this->code == 0x2E || this->code == 0x3E) {
+			// Pixels are read in 18 bit format, one byte per component
+			uint8_t component = (index - 1) % 3;
+			if (component == 0) {
+				uint16_t color = this->readPixel();
+				this->readComponents[0] = (color >> 8) & 0xF8;
+				this->readComponents[1] = (color >> 3) & 0xFC;
+				this->readComponents[2] = (color << 3) & 0xF8;
+			}
+
+			return this->readComponents[component];
+		}
+
+		// Simulated panel reports ID 0x009486
+		static const uint8_t id[3] = {0x00, 0x94, 0x86};
+		if ((this->code == 0x04 || this->code == 0xD3) && index <= 3) { return id[index - 1]; }
+		if (this->code == 0x0B && index == 1) { return this->memoryAccess; }
+
+		return 0;
+	}
+
+	// Data is written in 16 bit words, parameters are in lower byte
+	if (!this->half) {
+		this->high = value;
+		this->half = true;
+		return 0;
+	}
+
+	this->half = false;
+	uint16_t word = ((uint16_t)this->high << 8) | value;
+
+	if (this->code == 0x2C || this->code == 0x3C) {
+		this->writePixel(word);
+	} else {
+		this->parameter(word & 0xFF);
+	}
+
+	return 0;
+}
+
+void ILI9486LoopbackBus::parameter(uint8_t value) {
+	uint8_t index = this->parameters++;
+
+	switch (this->code) {
+	case 0x2A:
+		if (index == 0) { this->columnStart = (this->columnStart & 0x00FF) | (value << 8); }
+		if (index == 1) { this->columnStart = (this->columnStart & 0xFF00) | value; }
+		if (index == 2) { this->columnEnd = (this->columnEnd & 0x00FF) | (value << 8); }
+		if (index == 3) { this->columnEnd = (this->columnEnd & 0xFF00) | value; }
+		break;
+	case 0x2B:
+		if (index == 0) { this->pageStart = (this->pageStart & 0x00FF) | (value << 8); }
+		if (index == 1) { this->pageStart = (this->pageStart & 0xFF00) | value; }
+		if (index == 2) { this->pageEnd = (this->pageEnd & 0x00FF) | (value << 8); }
+		if (index == 3) { this->pageEnd = (this->pageEnd & 0xFF00) | value; }
+		break;
+	case 0x36:
+		this->memoryAccess = value;
+		break;
+	}
+}
+
+void ILI9486LoopbackBus::writePixel(uint16_t color) {
+	uint16_t *pixel = this->address();
+	if (pixel != NULL) {
+		*pixel = color;
+	}
+
+	this->pixels++;
+	this->advance();
+}
+
+uint16_t ILI9486LoopbackBus::readPixel() {
+	uint16_t *pixel = this->address();
+	uint16_t color = pixel != NULL ? *pixel : 0;
+
+	this->advance();
+	return color;
+}
+
+uint16_t *ILI9486LoopbackBus::address() {
+	// Row / column exchange is applied first, mirroring is applied to GRAM address
+	uint16_t c = this->column;
+	uint16_t r = this->page;
+
+	if (this->memoryAccess & 0x20) {
+		uint16_t tmp = c;
+		c = r;
+		r = tmp;
+	}
+
+	if (c >= ILI9486_LOOPBACK_COLUMNS || r >= ILI9486_LOOPBACK_PAGES) { return NULL; }
+
+	if (this->memoryAccess & 0x40) {
+		c = ILI9486_LOOPBACK_COLUMNS - 1 - c;
+	}
+
+	if (this->memoryAccess & 0x80) {
+		r = ILI9486_LOOPBACK_PAGES - 1 - r;
+	}
+
+	return &this->gram[(uint32_t)r * ILI9486_LOOPBACK_COLUMNS + c];
+}
+
+void ILI9486LoopbackBus::advance() {
+	if (this->column < this->columnEnd) {
+		this->column++;
+		return;
+	}
+
+	// Window is written again from the beginning after its last pixel
+	this->column = this->columnStart;
+	this->page = this->page < this->pageEnd ? this->page + 1 : this->pageStart;
+}
+
+bool ILI9486LoopbackBus::isRead(uint8_t code) {
+	switch (code) {
+	case 0x04: case 0x09: case 0x0A: case 0x0B: case 0x0C: case 0x0D: case 0x0E: case 0x0F:
+	case 0x2E: case 0x3E: case 0x45: case 0xD3: case 0xDA: case 0xDB: case 0xDC:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void ILI9486LoopbackBus::wait(uint32_t bytes) {
+	if (this->speed == 0) { return; }
+
+	// Messages are queued on simulated link, caller waits until its message is sent
+	uint64_t now = monotonic();
+	if (this->clock < now) {
+		this->clock = now;
+	}
+	this->clock += (uint64_t)bytes * 8 * 1000000000ULL / this->speed;
+
+	struct timespec ts;
+	ts.tv_sec = this->clock / 1000000000ULL;
+	ts.tv_nsec = this->clock % 1000000000ULL;
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
@@ -0,0 +1,89 @@
+/*
+ILI9486LoopbackBus.h
+Class ILI9486LoopbackBus represent simulated display, which executes SPI messages
+like ILI9486 panel and keeps its GRAM in shared memory.
+It is used to test and measure library on Linux machines without display.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "ILI9486Bus.h"
+
+// Size of simulated message buffer, like spidev bufsiz raised for displays
+#define ILI9486_LOOPBACK_MESSAGE 65536
+
+// GRAM dimensions, columns are along short side
+#define ILI9486_LOOPBACK_COLUMNS 320
+#define ILI9486_LOOPBACK_PAGES 480
+
+class ILI9486LoopbackBus : public ILI9486Bus {
+public:
+	// If path is given GRAM is mapped from that file (for example in /dev/shm), so other processes can watch it
+	// With speed different than 0 messages take as long as on SPI link with that clock
+	ILI9486LoopbackBus(uint8_t chipSelect, uint8_t dataCommand, uint32_t speed = 0, const char *path = NULL);
+	~ILI9486LoopbackBus();
+
+	bool message(struct spi_ioc_transfer *transfers, uint32_t count);
+	uint32_t getMessageSize();
+
+	void setPinMode(uint8_t pin, uint8_t mode);
+	void writePin(uint8_t pin, uint8_t value);
+
+	const uint16_t *getGRAM(); // Pixels in GRAM order, ILI9486_LOOPBACK_COLUMNS per page
+	uint16_t getPixel(uint16_t column, uint16_t page); // Pixel at GRAM address, independent of memory access control
+
+	uint32_t getMessages();
+	uint32_t getTransfers();
+	uint64_t getBytes();
+	uint64_t getPixels(); // Number of pixels written to GRAM
+	uint32_t getWindows(); // Number of memory write commands
+	void resetCounters();
+
+private:
+	void deselect(); // Chip select went high, serial interface is reset
+	void command(uint8_t code);
+	uint8_t data(uint8_t value); // Returns byte read from panel
+	void parameter(uint8_t value);
+	void writePixel(uint16_t color);
+	uint16_t readPixel();
+	uint16_t *address(); // GRAM location of current column and page, NULL outside GRAM
+	void advance(); // Move to next pixel of window
+	bool isRead(uint8_t code); // Whether command reads data from panel
+	void wait(uint32_t bytes); // Simulate time of transfer on SPI link
+
+	uint16_t *gram;
+	int file; // Descriptor of GRAM file, -1 for anonymous memory
+
+	uint8_t code; // Current command
+	uint8_t parameters; // Number of parameters received for current command
+	uint8_t high; // First byte of 16 bit word
+	bool half; // Whether first byte of word was received
+
+	uint16_t columnStart, columnEnd, pageStart, pageEnd; // Window, ends are included
+	uint16_t column, page; // Current address
+	uint8_t memoryAccess; // MADCTL register
+
+	uint32_t readIndex; // Number of bytes read since read command
+	uint8_t readComponents[3]; // Components of pixel being read
+
+	uint64_t clock; // Time when simulated link is free [ns]
+
+	uint32_t messages;
+	uint32_t transfers;
+	uint64_t bytes;
+	uint64_t pixels;
+	uint32_t windows;
+};
@@ -0,0 +1,208 @@
+/*
+ILI9486Mirror.cpp
+Implementation of ILI9486Mirror class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486Mirror.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+ILI9486Mirror::ILI9486Mirror(ILI9486 *display, const void *source, uint32_t stride, Format format):
+	display(display),
+	source((const uint8_t*)source),
+	stride(stride),
+	format(format),
+	converter(ILI9486Converter::XRGB8888),
+	valid(false)
+{
+	this->bytesPerPixel = format == RGB565 ? 2 : 4;
+	this->width = display->getWidth();
+	this->height = display->getHeight();
+
+	this->previous = new uint8_t[(uint32_t)this->width * this->height * this->bytesPerPixel];
+	this->spanStart = new uint16_t[this->height];
+	this->spanEnd = new uint16_t[this->height];
+}
+
+ILI9486Mirror::~ILI9486Mirror() {
+	delete[] this->previous;
+	delete[] this->spanStart;
+	delete[] this->spanEnd;
+}
+
+bool ILI9486Mirror::update(ILI9486MirrorStats *stats) {
+	ILI9486MirrorStats result;
+	memset(&result, 0, sizeof(result));
+
+	uint32_t rowBytes = (uint32_t)this->width * this->bytesPerPixel;
+	unsigned long start = micros();
+
+	// Rows are found first, so time of diffing and sending can be reported separately
+	uint16_t *spanStart = this->spanStart;
+	uint16_t *spanEnd = this->spanEnd;
+
+	for (uint16_t y = 0; y < this->height; y++) {
+		const uint8_t *row = this->getRow(y);
+		uint8_t *copy = this->previous + (uint32_t)y * rowBytes;
+		uint32_t first, last;
+
+		if (!this->valid) {
+			first = 0;
+			last = rowBytes - 1;
+		} else if (!findChange(row, copy, rowBytes, &first, &last)) {
+			spanStart[y] = spanEnd[y] = 0;
+			continue;
+		}
+
+		spanStart[y] = first / this->bytesPerPixel;
+		spanEnd[y] = last / this->bytesPerPixel + 1;
+		result.changed += spanEnd[y] - spanStart[y];
+
+		memcpy(copy + first, row + first, last + 1 - first);
+	}
+
+	result.diffTime = micros() - start;
+	start = micros();
+
+	// Consecutive rows are merged into one window while unchanged pixels cost less than opening new window
+	uint16_t xStart = 0, xEnd = 0, yStart = 0;
+	uint32_t used = 0; // Changed pixels inside current window
+	bool open = false;
+
+	for (uint16_t y = 0; y <= this->height; y++) {
+		bool changed = y < this->height && spanEnd[y] > spanStart[y];
+
+		if (open && changed) {
+			uint16_t left = spanStart[y] < xStart ? spanStart[y] : xStart;
+			uint16_t right = spanEnd[y] > xEnd ? spanEnd[y] : xEnd;
+			uint32_t area = (uint32_t)(right - left) * (y + 1 - yStart);
+
+			if (area - (used + spanEnd[y] - spanStart[y]) <= ILI9486_MIRROR_WINDOW_COST) {
+				xStart = left;
+				xEnd = right;
+				used += spanEnd[y] - spanStart[y];
+				continue;
+			}
+		}
+
+		if (open) {
+			this->sendWindow(xStart, yStart, xEnd, y);
+			result.sent += (uint32_t)(xEnd - xStart) * (y - yStart);
+			result.windows++;
+			open = false;
+		}
+
+		if (changed) {
+			xStart = spanStart[y];
+			xEnd = spanEnd[y];
+			yStart = y;
+			used = xEnd - xStart;
+			open = true;
+		}
+	}
+
+	SPI.flush();
+	result.transferTime = micros() - start;
+
+	this->valid = true;
+
+	if (stats != NULL) {
+		*stats = result;
+	}
+
+	return result.changed > 0;
+}
+
+void ILI9486Mirror::invalidate() {
+	this->valid = false;
+}
+
+bool ILI9486Mirror::findChange(const uint8_t *a, const uint8_t *b, uint32_t n, uint32_t *first, uint32_t *last) {
+	uint32_t i = 0;
+	uint32_t j = n;
+
+	// Whole 16 byte blocks are compared from both ends, then bytes inside differing block
+#if defined(__SSE2__)
+	while (i + 16 <= n && _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)))) == 0xFFFF) {
+		i += 16;
+	}
+#elif defined(__ARM_NEON)
+	while (i + 16 <= n) {
+		uint8x16_t equal = vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+		uint64x2_t halves = vreinterpretq_u64_u8(equal);
+		if ((vgetq_lane_u64(halves, 0) & vgetq_lane_u64(halves, 1)) != ~0ULL) { break; }
+		i += 16;
+	}
+#else
+	while (i + 8 <= n && memcmp(a + i, b + i, 8) == 0) {
+		i += 8;
+	}
+#endif
+
+	while (i < n && a[i] == b[i]) {
+		i++;
+	}
+
+	if (i == n) { return false; }
+
+#if defined(__SSE2__)
+	while (j >= i + 16 && _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + j - 16)), _mm_loadu_si128((const __m128i*)(b + j - 16)))) == 0xFFFF) {
+		j -= 16;
+	}
+#elif defined(__ARM_NEON)
+	while (j >= i + 16) {
+		uint8x16_t equal = vceqq_u8(vld1q_u8(a + j - 16), vld1q_u8(b + j - 16));
+		uint64x2_t halves = vreinterpretq_u64_u8(equal);
+		if ((vgetq_lane_u64(halves, 0) & vgetq_lane_u64(halves, 1)) != ~0ULL) { break; }
+		j -= 16;
+	}
+#else
+	while (j >= i + 8 && memcmp(a + j - 8, b + j - 8, 8) == 0) {
+		j -= 8;
+	}
+#endif
+
+	while (a[j - 1] == b[j - 1]) {
+		j--;
+	}
+
+	*first = i;
+	*last = j - 1;
+	return true;
+}
+
+void ILI9486Mirror::sendWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+	this->display->openWindow(xStart, yStart, xEnd, yEnd);
+
+	for (uint16_t y = yStart; y < yEnd; y++) {
+		const uint8_t *row = this->getRow(y);
+
+		if (this->format == RGB565) {
+			this->display->writeBuffer((const ILI9486_COLOR*)row + xStart, xEnd - xStart);
+			continue;
+		}
+
+		this->converter.write(this->display, row + xStart * 4, xEnd - xStart, xStart, y);
+	}
+}
+
+const uint8_t *ILI9486Mirror::getRow(uint16_t y) {
+	return this->source + (uint32_t)y * this->stride;
+}
@@ -0,0 +1,70 @@
+/*
+ILI9486Mirror.h
+Class ILI9486Mirror copies region of memory mapped framebuffer to display,
+sending only areas which changed since previous update.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <ILI9486.h>
+#include <ILI9486Converter.h>
+
+// Cost of opening window expressed in pixels, rows are merged into one window while it sends less unchanged pixels
+#define ILI9486_MIRROR_WINDOW_COST 32
+
+// Result of single update
+struct ILI9486MirrorStats {
+	uint32_t changed; // Number of changed pixels
+	uint32_t sent; // Number of pixels sent, includes unchanged pixels inside merged windows
+	uint32_t windows;
+	uint32_t diffTime; // Time of finding changes [us]
+	uint32_t transferTime; // Time of converting and sending pixels [us]
+};
+
+class ILI9486Mirror {
+public:
+	enum Format {
+		RGB565,
+		XRGB8888
+	};
+
+	// Source points at first pixel of mirrored region, region has display size, stride is distance between rows in bytes
+	ILI9486Mirror(ILI9486 *display, const void *source, uint32_t stride, Format format);
+	~ILI9486Mirror();
+
+	bool update(ILI9486MirrorStats *stats = NULL); // Send changed areas, returns whether anything changed
+	void invalidate(); // Send whole region on next update
+
+	static bool findChange(const uint8_t *a, const uint8_t *b, uint32_t n, uint32_t *first, uint32_t *last); // Find first and last differing byte of two rows
+
+private:
+	void sendWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd); // Convert and send rectangle of source
+	const uint8_t *getRow(uint16_t y);
+
+	ILI9486 *display;
+	const uint8_t *source;
+	uint32_t stride;
+	Format format;
+	uint8_t bytesPerPixel;
+	uint16_t width;
+	uint16_t height;
+
+	uint8_t *previous; // Copy of source from last update, rows are packed
+	ILI9486Converter converter; // Converts XRGB8888 rows straight into SPI queue
+	uint16_t *spanStart; // First changed pixel of every row
+	uint16_t *spanEnd; // Pixel after last changed one, equal to spanStart for unchanged rows
+	bool valid; // Whether previous copy matches display
+};
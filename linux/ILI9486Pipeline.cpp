@@ -0,0 +1,282 @@
+/*
+ILI9486Pipeline.cpp
+Implementation of ILI9486Pipeline class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486Pipeline.h"
+
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+
+// Number of yields before waiting thread starts sleeping
+#define ILI9486_PIPELINE_SPINS 64
+
+// Sleep of waiting thread [us]
+#define ILI9486_PIPELINE_SLEEP 100
+
+ILI9486BandQueue::ILI9486BandQueue(uint32_t capacity):
+	capacity(capacity),
+	head(0),
+	tail(0)
+{
+	this->slots = new ILI9486Band*[capacity];
+}
+
+ILI9486BandQueue::~ILI9486BandQueue() {
+	delete[] this->slots;
+}
+
+bool ILI9486BandQueue::push(ILI9486Band *band) {
+	uint32_t tail = this->tail;
+	if (tail - __atomic_load_n(&this->head, __ATOMIC_ACQUIRE) == this->capacity) { return false; }
+
+	// Band content becomes visible to consumer together with new tail
+	this->slots[tail % this->capacity] = band;
+	__atomic_store_n(&this->tail, tail + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+ILI9486Band *ILI9486BandQueue::pop() {
+	uint32_t head = this->head;
+	if (head == __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE)) { return NULL; }
+
+	ILI9486Band *band = this->slots[head % this->capacity];
+	__atomic_store_n(&this->head, head + 1, __ATOMIC_RELEASE);
+	return band;
+}
+
+uint32_t ILI9486BandQueue::getDepth() {
+	return __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&this->head, __ATOMIC_ACQUIRE);
+}
+
+ILI9486Pipeline::ILI9486Pipeline(ILI9486 *display, ILI9486Converter::Format format, ILI9486Converter::Dither dither, uint16_t bandHeight, uint8_t depth):
+	display(display),
+	converter(format, dither, display->getWidth()),
+	depth(depth),
+	available(depth),
+	rendered(depth),
+	converted(depth),
+	running(true),
+	submitted(0),
+	maxRendered(0),
+	maxConverted(0),
+	stallTime(0)
+{
+	this->bytesPerPixel = format == ILI9486Converter::RGB888 ? 3 : 4;
+
+	memset(&this->totals, 0, sizeof(this->totals));
+	memset(&this->base, 0, sizeof(this->base));
+
+	// Every band holds full rows, all of them start free
+	this->bands = new ILI9486Band[depth];
+	for (uint8_t i = 0; i < depth; i++) {
+		ILI9486Band *band = &this->bands[i];
+		band->capacity = (uint32_t)display->getWidth() * bandHeight;
+		band->pixels = new uint8_t[band->capacity * this->bytesPerPixel];
+		band->colors = new uint8_t[band->capacity * 2];
+		this->available.push(band);
+	}
+
+	pthread_create(&this->converterThread, NULL, convertThread, this);
+	pthread_create(&this->transmitterThread, NULL, transmitThread, this);
+}
+
+ILI9486Pipeline::~ILI9486Pipeline() {
+	this->flush();
+
+	__atomic_store_n(&this->running, false, __ATOMIC_RELEASE);
+	pthread_join(this->converterThread, NULL);
+	pthread_join(this->transmitterThread, NULL);
+
+	for (uint8_t i = 0; i < this->depth; i++) {
+		delete[] this->bands[i].pixels;
+		delete[] this->bands[i].colors;
+	}
+	delete[] this->bands;
+}
+
+ILI9486Band *ILI9486Pipeline::acquire() {
+	ILI9486Band *band = this->available.pop();
+
+	if (band == NULL) {
+		// Every band is in flight, application waits for transmitter
+		unsigned long start = micros();
+		uint32_t attempts = 0;
+
+		while ((band = this->available.pop()) == NULL) {
+			wait(&attempts);
+		}
+
+		__atomic_store_n(&this->stallTime, this->stallTime + (micros() - start), __ATOMIC_RELAXED);
+	}
+
+	band->acquired = micros();
+	return band;
+}
+
+void ILI9486Pipeline::submit(ILI9486Band *band, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	band->x = x;
+	band->y = y;
+	band->width = width;
+	band->height = height;
+	band->submitted = micros();
+
+	// Rendered queue has room for every band
+	this->rendered.push(band);
+	__atomic_store_n(&this->submitted, this->submitted + 1, __ATOMIC_RELEASE);
+
+	uint32_t depth = this->rendered.getDepth();
+	if (depth > this->maxRendered) {
+		__atomic_store_n(&this->maxRendered, depth, __ATOMIC_RELAXED);
+	}
+}
+
+void ILI9486Pipeline::flush() {
+	uint32_t attempts = 0;
+
+	while (__atomic_load_n(&this->totals.bands, __ATOMIC_ACQUIRE) != this->submitted) {
+		wait(&attempts);
+	}
+}
+
+void ILI9486Pipeline::getStats(ILI9486PipelineStats *stats) {
+	Totals totals;
+	totals.bands = __atomic_load_n(&this->totals.bands, __ATOMIC_ACQUIRE);
+	totals.renderTime = __atomic_load_n(&this->totals.renderTime, __ATOMIC_RELAXED);
+	totals.convertTime = __atomic_load_n(&this->totals.convertTime, __ATOMIC_RELAXED);
+	totals.transmitTime = __atomic_load_n(&this->totals.transmitTime, __ATOMIC_RELAXED);
+	totals.latency = __atomic_load_n(&this->totals.latency, __ATOMIC_RELAXED);
+
+	uint32_t bands = totals.bands - this->base.bands;
+	uint32_t divisor = bands > 0 ? bands : 1;
+
+	stats->bands = bands;
+	stats->rendered = this->rendered.getDepth();
+	stats->converted = this->converted.getDepth();
+	stats->maxRendered = __atomic_load_n(&this->maxRendered, __ATOMIC_RELAXED);
+	stats->maxConverted = __atomic_load_n(&this->maxConverted, __ATOMIC_RELAXED);
+	stats->renderTime = (totals.renderTime - this->base.renderTime) / divisor;
+	stats->convertTime = (totals.convertTime - this->base.convertTime) / divisor;
+	stats->transmitTime = (totals.transmitTime - this->base.transmitTime) / divisor;
+	stats->latency = (totals.latency - this->base.latency) / divisor;
+	stats->stallTime = __atomic_load_n(&this->stallTime, __ATOMIC_RELAXED);
+}
+
+void ILI9486Pipeline::resetStats() {
+	// Sums of transmitter are only read, later stats are differences from this snapshot
+	this->base.bands = __atomic_load_n(&this->totals.bands, __ATOMIC_ACQUIRE);
+	this->base.renderTime = __atomic_load_n(&this->totals.renderTime, __ATOMIC_RELAXED);
+	this->base.convertTime = __atomic_load_n(&this->totals.convertTime, __ATOMIC_RELAXED);
+	this->base.transmitTime = __atomic_load_n(&this->totals.transmitTime, __ATOMIC_RELAXED);
+	this->base.latency = __atomic_load_n(&this->totals.latency, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&this->maxRendered, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&this->maxConverted, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&this->stallTime, 0, __ATOMIC_RELAXED);
+}
+
+void *ILI9486Pipeline::convertThread(void *pipeline) {
+	((ILI9486Pipeline*)pipeline)->convertBands();
+	return NULL;
+}
+
+void *ILI9486Pipeline::transmitThread(void *pipeline) {
+	((ILI9486Pipeline*)pipeline)->transmitBands();
+	return NULL;
+}
+
+void ILI9486Pipeline::convertBands() {
+	uint32_t attempts = 0;
+
+	while (__atomic_load_n(&this->running, __ATOMIC_ACQUIRE)) {
+		ILI9486Band *band = this->rendered.pop();
+		if (band == NULL) {
+			wait(&attempts);
+			continue;
+		}
+
+		attempts = 0;
+		band->converting = micros();
+
+		uint32_t rowBytes = (uint32_t)band->width * this->bytesPerPixel;
+		for (uint16_t row = 0; row < band->height; row++) {
+			this->converter.convertForTransfer(band->pixels + row * rowBytes, band->colors + (uint32_t)row * band->width * 2, band->width, band->x, band->y + row);
+		}
+
+		band->converted = micros();
+
+		// Converted queue has room for every band
+		this->converted.push(band);
+
+		uint32_t depth = this->converted.getDepth();
+		if (depth > this->maxConverted) {
+			__atomic_store_n(&this->maxConverted, depth, __ATOMIC_RELAXED);
+		}
+	}
+}
+
+void ILI9486Pipeline::transmitBands() {
+	uint32_t attempts = 0;
+	uint32_t messageSize = SPI.getMessageSize();
+
+	while (__atomic_load_n(&this->running, __ATOMIC_ACQUIRE)) {
+		ILI9486Band *band = this->converted.pop();
+		if (band == NULL) {
+			wait(&attempts);
+			continue;
+		}
+
+		attempts = 0;
+		unsigned long start = micros();
+
+		// Colors are already in SPI byte order, they are copied to queue in message sized chunks
+		this->display->openWindow(band->x, band->y, band->x + band->width, band->y + band->height);
+		this->display->beginWrite();
+
+		const uint8_t *colors = band->colors;
+		uint32_t count = (uint32_t)band->width * band->height * 2;
+
+		while (count > 0) {
+			uint32_t chunk = count < messageSize ? count : messageSize;
+			memcpy(SPI.reserve(chunk), colors, chunk);
+			colors += chunk;
+			count -= chunk;
+		}
+
+		this->display->endWrite();
+		SPI.flush();
+
+		unsigned long end = micros();
+		__atomic_store_n(&this->totals.renderTime, this->totals.renderTime + (band->submitted - band->acquired), __ATOMIC_RELAXED);
+		__atomic_store_n(&this->totals.convertTime, this->totals.convertTime + (band->converted - band->converting), __ATOMIC_RELAXED);
+		__atomic_store_n(&this->totals.transmitTime, this->totals.transmitTime + (end - start), __ATOMIC_RELAXED);
+		__atomic_store_n(&this->totals.latency, this->totals.latency + (end - band->submitted), __ATOMIC_RELAXED);
+
+		this->available.push(band);
+		__atomic_store_n(&this->totals.bands, this->totals.bands + 1, __ATOMIC_RELEASE);
+	}
+}
+
+void ILI9486Pipeline::wait(uint32_t *attempts) {
+	// Short waits only yield, long ones sleep so idle pipeline doesn't use processor
+	if (*attempts < ILI9486_PIPELINE_SPINS) {
+		(*attempts)++;
+		sched_yield();
+	} else {
+		usleep(ILI9486_PIPELINE_SLEEP);
+	}
+}
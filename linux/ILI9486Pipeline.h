@@ -0,0 +1,122 @@
+/*
+ILI9486Pipeline.h
+Class ILI9486Pipeline sends bands of rows rendered by application, converting
+and transmitting them on separate threads connected by lock-free queues.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <pthread.h>
+
+#include <ILI9486.h>
+#include <ILI9486Converter.h>
+
+// Rectangle of rows passing through pipeline
+struct ILI9486Band {
+	uint8_t *pixels; // Rendered pixels in format of pipeline, rows are packed
+	uint8_t *colors; // Converted colors, most significant byte first
+	uint32_t capacity; // Maximum number of pixels
+	uint16_t x;
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+	unsigned long acquired; // Times of passing stages [us]
+	unsigned long submitted;
+	unsigned long converting;
+	unsigned long converted;
+};
+
+// Bounded queue of bands with one producer and one consumer thread
+class ILI9486BandQueue {
+public:
+	ILI9486BandQueue(uint32_t capacity);
+	~ILI9486BandQueue();
+
+	bool push(ILI9486Band *band); // Returns false when queue is full
+	ILI9486Band *pop(); // Returns NULL when queue is empty
+	uint32_t getDepth(); // Number of queued bands
+
+private:
+	ILI9486Band **slots;
+	uint32_t capacity;
+	uint32_t head; // Count of popped bands, written only by consumer
+	uint32_t tail; // Count of pushed bands, written only by producer
+};
+
+// Counters since creation or resetStats, times are averages per band
+struct ILI9486PipelineStats {
+	uint32_t bands; // Number of transmitted bands
+	uint32_t rendered; // Bands waiting for conversion
+	uint32_t converted; // Bands waiting for transmission
+	uint32_t maxRendered; // Largest depth of queues
+	uint32_t maxConverted;
+	uint32_t renderTime; // From acquiring band to submitting it [us]
+	uint32_t convertTime; // Conversion [us]
+	uint32_t transmitTime; // From start of transmission to end of SPI message [us]
+	uint32_t latency; // From submitting band to end of its transmission [us]
+	uint32_t stallTime; // Total time application waited for free band [us]
+};
+
+class ILI9486Pipeline {
+public:
+	// Display must not be used by other code while pipeline has bands in flight, call flush before
+	ILI9486Pipeline(ILI9486 *display, ILI9486Converter::Format format, ILI9486Converter::Dither dither = ILI9486Converter::NO_DITHER, uint16_t bandHeight = 16, uint8_t depth = 8);
+	~ILI9486Pipeline(); // Sends submitted bands and stops threads
+
+	ILI9486Band *acquire(); // Wait for free band, it holds display width times band height pixels
+	void submit(ILI9486Band *band, uint16_t x, uint16_t y, uint16_t width, uint16_t height); // Queue band for rectangle (exclusive end is x + width, y + height)
+	void flush(); // Wait until all submitted bands are on display
+
+	void getStats(ILI9486PipelineStats *stats);
+	void resetStats();
+
+private:
+	static void *convertThread(void *pipeline);
+	static void *transmitThread(void *pipeline);
+	void convertBands();
+	void transmitBands();
+	static void wait(uint32_t *attempts); // Back off while queue is empty or full
+
+	ILI9486 *display;
+	ILI9486Converter converter;
+	uint8_t bytesPerPixel;
+	uint8_t depth;
+
+	ILI9486Band *bands;
+	ILI9486BandQueue available; // Transmitter to application
+	ILI9486BandQueue rendered; // Application to converter
+	ILI9486BandQueue converted; // Converter to transmitter
+
+	pthread_t converterThread;
+	pthread_t transmitterThread;
+	bool running;
+
+	// Sums written by transmitter when band is done
+	struct Totals {
+		uint32_t bands;
+		uint64_t renderTime;
+		uint64_t convertTime;
+		uint64_t transmitTime;
+		uint64_t latency;
+	};
+
+	Totals totals;
+	Totals base; // Totals at last reset
+	uint32_t submitted; // Written by application
+	uint32_t maxRendered; // Written by application
+	uint32_t maxConverted; // Written by converter
+	uint64_t stallTime; // Written by application
+};
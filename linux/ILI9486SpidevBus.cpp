@@ -0,0 +1,128 @@
+/*
+ILI9486SpidevBus.cpp
+Implementation of ILI9486SpidevBus class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486SpidevBus.h"
+#include "Arduino.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+ILI9486SpidevBus::ILI9486SpidevBus(const char *device, const char *gpioChip, uint8_t chipSelect, uint8_t dataCommand, uint32_t speed):
+	ILI9486Bus(chipSelect, dataCommand, speed),
+	messageSize(ILI9486_SPIDEV_BUFSIZ)
+{
+	for (uint16_t i = 0; i < ILI9486_BUS_PINS; i++) {
+		this->lines[i] = -1;
+	}
+
+	this->device = open(device, O_RDWR);
+	if (this->device < 0) {
+		perror(device);
+	} else {
+		uint8_t mode = SPI_MODE_0;
+		uint8_t bits = 8;
+		ioctl(this->device, SPI_IOC_WR_MODE, &mode);
+		ioctl(this->device, SPI_IOC_WR_BITS_PER_WORD, &bits);
+		ioctl(this->device, SPI_IOC_WR_MAX_SPEED_HZ, &speed);
+	}
+
+	this->gpioChip = open(gpioChip, O_RDWR);
+	if (this->gpioChip < 0) {
+		perror(gpioChip);
+	}
+
+	// Whole message is copied through spidev buffer, so its size limits message length
+	FILE *parameter = fopen("/sys/module/spidev/parameters/bufsiz", "r");
+	if (parameter != NULL) {
+		unsigned int bufsiz;
+		if (fscanf(parameter, "%u", &bufsiz) == 1 && bufsiz > 0) {
+			this->messageSize = bufsiz;
+		}
+		fclose(parameter);
+	}
+}
+
+ILI9486SpidevBus::~ILI9486SpidevBus() {
+	for (uint16_t i = 0; i < ILI9486_BUS_PINS; i++) {
+		if (this->lines[i] >= 0) {
+			close(this->lines[i]);
+		}
+	}
+
+	if (this->gpioChip >= 0) {
+		close(this->gpioChip);
+	}
+
+	if (this->device >= 0) {
+		close(this->device);
+	}
+}
+
+bool ILI9486SpidevBus::isOpen() {
+	return this->device >= 0 && this->gpioChip >= 0;
+}
+
+bool ILI9486SpidevBus::message(struct spi_ioc_transfer *transfers, uint32_t count) {
+	if (ioctl(this->device, SPI_IOC_MESSAGE(count), transfers) < 0) {
+		perror("SPI_IOC_MESSAGE");
+		return false;
+	}
+
+	return true;
+}
+
+uint32_t ILI9486SpidevBus::getMessageSize() {
+	return this->messageSize;
+}
+
+void ILI9486SpidevBus::setPinMode(uint8_t pin, uint8_t mode) {
+	if (this->lines[pin] >= 0) {
+		close(this->lines[pin]);
+		this->lines[pin] = -1;
+	}
+
+	struct gpio_v2_line_request request;
+	memset(&request, 0, sizeof(request));
+	request.offsets[0] = pin;
+	request.num_lines = 1;
+	request.config.flags = mode == OUTPUT ? GPIO_V2_LINE_FLAG_OUTPUT : GPIO_V2_LINE_FLAG_INPUT;
+	strncpy(request.consumer, "ILI9486", sizeof(request.consumer) - 1);
+
+	if (ioctl(this->gpioChip, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+		perror("GPIO_V2_GET_LINE_IOCTL");
+		return;
+	}
+
+	this->lines[pin] = request.fd;
+}
+
+void ILI9486SpidevBus::writePin(uint8_t pin, uint8_t value) {
+	if (this->lines[pin] < 0) { return; }
+
+	struct gpio_v2_line_values values;
+	values.bits = value;
+	values.mask = 1;
+
+	if (ioctl(this->lines[pin], GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0) {
+		perror("GPIO_V2_LINE_SET_VALUES_IOCTL");
+	}
+}
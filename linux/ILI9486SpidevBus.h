@@ -0,0 +1,46 @@
+/*
+ILI9486SpidevBus.h
+Class ILI9486SpidevBus represent display connected to spidev device,
+with data / command, reset and backlight pins on GPIO character device.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "ILI9486Bus.h"
+
+// Size of spidev buffer when it can't be read from module parameters
+#define ILI9486_SPIDEV_BUFSIZ 4096
+
+class ILI9486SpidevBus : public ILI9486Bus {
+public:
+	// Pins are line offsets on GPIO chip, chip select is hardware chip select of spidev device
+	ILI9486SpidevBus(const char *device, const char *gpioChip, uint8_t chipSelect, uint8_t dataCommand, uint32_t speed);
+	~ILI9486SpidevBus();
+
+	bool isOpen(); // Whether SPI device and GPIO chip were opened
+
+	bool message(struct spi_ioc_transfer *transfers, uint32_t count);
+	uint32_t getMessageSize(); // Value of spidev bufsiz module parameter
+
+	void setPinMode(uint8_t pin, uint8_t mode);
+	void writePin(uint8_t pin, uint8_t value);
+
+private:
+	int device; // spidev file descriptor
+	int gpioChip;
+	int lines[ILI9486_BUS_PINS]; // Line request file descriptors, -1 if line was not requested
+	uint32_t messageSize;
+};
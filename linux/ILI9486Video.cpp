@@ -0,0 +1,208 @@
+/*
+ILI9486Video.cpp
+Implementation of ILI9486Video class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "ILI9486Video.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+ILI9486Video::ILI9486Video(ILI9486 *display):
+	display(display),
+	descriptor(-1),
+	mapping(NULL),
+	size(0),
+	frames(NULL),
+	count(0),
+	width(0),
+	height(0),
+	fps(0),
+	bigEndian(false),
+	stopped(false)
+{}
+
+ILI9486Video::~ILI9486Video() {
+	this->close();
+}
+
+bool ILI9486Video::open(const char *path) {
+	if (!this->map(path)) { return false; }
+
+	const ILI9486VideoHeader *header = (const ILI9486VideoHeader*)this->mapping;
+	uint32_t frameBytes = this->size < sizeof(ILI9486VideoHeader) ? 0 : (uint32_t)header->width * header->height * 2;
+
+	if (frameBytes == 0 || memcmp(header->magic, ILI9486_VIDEO_MAGIC, 4) != 0 || (this->size - sizeof(ILI9486VideoHeader)) / frameBytes < header->frames) {
+		fprintf(stderr, "%s: not a video file or file is truncated\n", path);
+		this->close();
+		return false;
+	}
+
+	this->frames = this->mapping + sizeof(ILI9486VideoHeader);
+	this->count = header->frames;
+	this->width = header->width;
+	this->height = header->height;
+	this->fps = header->fps;
+	this->bigEndian = (header->flags & ILI9486_VIDEO_BIG_ENDIAN) != 0;
+	return true;
+}
+
+bool ILI9486Video::openRaw(const char *path, uint16_t width, uint16_t height, bool bigEndian, uint16_t fps) {
+	if (width == 0 || height == 0 || !this->map(path)) { return false; }
+
+	// Incomplete frame at the end of file is ignored
+	this->frames = this->mapping;
+	this->count = (uint32_t)(this->size / ((uint32_t)width * height * 2));
+	this->width = width;
+	this->height = height;
+	this->fps = fps;
+	this->bigEndian = bigEndian;
+	return true;
+}
+
+void ILI9486Video::close() {
+	if (this->mapping != NULL) {
+		munmap(this->mapping, this->size);
+		this->mapping = NULL;
+	}
+
+	if (this->descriptor >= 0) {
+		::close(this->descriptor);
+		this->descriptor = -1;
+	}
+
+	this->frames = NULL;
+	this->count = 0;
+}
+
+uint16_t ILI9486Video::getWidth() {
+	return this->width;
+}
+
+uint16_t ILI9486Video::getHeight() {
+	return this->height;
+}
+
+uint16_t ILI9486Video::getFps() {
+	return this->fps;
+}
+
+uint32_t ILI9486Video::getFrames() {
+	return this->count;
+}
+
+void ILI9486Video::showFrame(uint32_t frame, uint16_t x, uint16_t y) {
+	uint32_t pixels = (uint32_t)this->width * this->height;
+	const uint8_t *data = this->frames + (size_t)frame * pixels * 2;
+
+	this->display->openWindow(x, y, x + this->width, y + this->height);
+
+	// Big endian frames are pointed to by SPI message, little endian ones are swapped into SPI queue
+	if (this->bigEndian) {
+		this->display->writeBytes(data, pixels);
+	} else {
+		this->display->writeBuffer((const ILI9486_COLOR*)data, pixels);
+	}
+
+	SPI.flush();
+}
+
+bool ILI9486Video::play(uint16_t x, uint16_t y, ILI9486VideoStats *stats, uint16_t fps, bool loop) {
+	ILI9486VideoStats result;
+	memset(&result, 0, sizeof(result));
+
+	if (x + this->width > this->display->getWidth() || y + this->height > this->display->getHeight()) {
+		if (stats != NULL) {
+			*stats = result;
+		}
+		return false;
+	}
+
+	if (fps == 0) {
+		fps = this->fps != 0 ? this->fps : 30;
+	}
+
+	this->stopped = false;
+
+	// Frame n is due at start + n * period, late player skips frames whose time has passed
+	unsigned long period = 1000000UL / fps;
+	unsigned long start = micros();
+	unsigned long transferTime = 0;
+	uint32_t frame = 0;
+
+	while (!this->stopped && this->count > 0 && (loop || frame < this->count)) {
+		unsigned long sent = micros();
+		this->showFrame(frame % this->count, x, y);
+		transferTime += micros() - sent;
+		result.shown++;
+		frame++;
+
+		unsigned long now = micros();
+		uint32_t due = (now - start) / period;
+
+		if (due > frame) {
+			uint32_t last = loop || due < this->count ? due : this->count;
+			result.dropped += last - frame;
+			frame = due;
+		} else if (due < frame) {
+			usleep(start + frame * period - now);
+		}
+	}
+
+	result.time = (micros() - start) / 1000;
+	result.transferTime = result.shown > 0 ? transferTime / result.shown : 0;
+	result.fps = result.time > 0 ? result.shown * 1000.0f / result.time : 0;
+
+	if (stats != NULL) {
+		*stats = result;
+	}
+
+	return !this->stopped;
+}
+
+void ILI9486Video::stop() {
+	this->stopped = true;
+}
+
+bool ILI9486Video::map(const char *path) {
+	this->close();
+
+	struct stat info;
+	this->descriptor = ::open(path, O_RDONLY);
+	if (this->descriptor < 0 || fstat(this->descriptor, &info) < 0 || info.st_size == 0) {
+		perror(path);
+		this->close();
+		return false;
+	}
+
+	this->size = info.st_size;
+	this->mapping = (uint8_t*)mmap(NULL, this->size, PROT_READ, MAP_SHARED, this->descriptor, 0);
+	if (this->mapping == MAP_FAILED) {
+		perror(path);
+		this->mapping = NULL;
+		this->close();
+		return false;
+	}
+
+	// Frames are read once from start to end, kernel reads ahead
+	madvise(this->mapping, this->size, MADV_SEQUENTIAL);
+	madvise(this->mapping, this->size, MADV_WILLNEED);
+	return true;
+}
@@ -0,0 +1,84 @@
+/*
+ILI9486Video.h
+Class ILI9486Video plays RGB565 video files mapped into memory, frames are
+sent straight from the mapping and paced to given frame rate.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <stddef.h>
+
+#include <ILI9486.h>
+
+#define ILI9486_VIDEO_MAGIC "I565"
+
+// Pixels of frames are stored most significant byte first, they are sent without copying
+#define ILI9486_VIDEO_BIG_ENDIAN 0x0001
+
+// Header of framed file, frames follow it, fields are little endian
+struct ILI9486VideoHeader {
+	char magic[4]; // ILI9486_VIDEO_MAGIC
+	uint16_t width;
+	uint16_t height;
+	uint16_t fps;
+	uint16_t flags;
+	uint32_t frames;
+};
+
+// Result of playing
+struct ILI9486VideoStats {
+	uint32_t shown; // Number of frames sent to display
+	uint32_t dropped; // Number of frames skipped to keep pace
+	uint32_t time; // Playing time [ms]
+	uint32_t transferTime; // Average time of sending frame [us]
+	float fps; // Achieved frames per second
+};
+
+class ILI9486Video {
+public:
+	ILI9486Video(ILI9486 *display);
+	~ILI9486Video();
+
+	bool open(const char *path); // Open framed file, returns false if it can't be mapped or header is invalid
+	bool openRaw(const char *path, uint16_t width, uint16_t height, bool bigEndian = true, uint16_t fps = 30); // Open file of frames without header, little endian frames are copied when sent
+	void close();
+
+	uint16_t getWidth();
+	uint16_t getHeight();
+	uint16_t getFps();
+	uint32_t getFrames();
+
+	void showFrame(uint32_t frame, uint16_t x, uint16_t y); // Send frame to display, upper left corner at (x, y)
+	bool play(uint16_t x, uint16_t y, ILI9486VideoStats *stats = NULL, uint16_t fps = 0, bool loop = false); // Play frames at fps (0 uses fps of file), returns false if frames don't fit on display (stats are zeroed) or playing was stopped
+	void stop(); // Stop playing, can be called from signal handler
+
+private:
+	bool map(const char *path);
+
+	ILI9486 *display;
+	int descriptor;
+	uint8_t *mapping;
+	size_t size;
+
+	const uint8_t *frames; // First frame
+	uint32_t count;
+	uint16_t width;
+	uint16_t height;
+	uint16_t fps;
+	bool bigEndian;
+
+	volatile bool stopped;
+};
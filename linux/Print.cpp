@@ -0,0 +1,120 @@
+/*
+Print.cpp
+Implementation of Print class for Linux builds.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "Print.h"
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+	size_t n = 0;
+
+	while (size--) {
+		n += this->write(*buffer++);
+	}
+
+	return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+	return this->write(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const char *str) {
+	return this->write(str);
+}
+
+size_t Print::print(char character) {
+	return this->write((uint8_t)character);
+}
+
+size_t Print::print(unsigned char value, int base) {
+	return this->print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base) {
+	return this->print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+	return this->print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base) {
+	if (base == DEC && value < 0) {
+		return this->write('-') + this->printNumber(-(unsigned long)value, DEC);
+	}
+
+	return this->printNumber(value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+	return this->printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+	size_t n = 0;
+
+	if (value < 0.0) {
+		n += this->write('-');
+		value = -value;
+	}
+
+	// Round to last printed digit
+	double rounding = 0.5;
+	for (int i = 0; i < digits; i++) {
+		rounding /= 10.0;
+	}
+	value += rounding;
+
+	unsigned long integer = (unsigned long)value;
+	double fraction = value - (double)integer;
+	n += this->printNumber(integer, DEC);
+
+	if (digits > 0) {
+		n += this->write('.');
+	}
+
+	while (digits-- > 0) {
+		fraction *= 10.0;
+		uint8_t digit = (uint8_t)fraction;
+		n += this->write('0' + digit);
+		fraction -= digit;
+	}
+
+	return n;
+}
+
+size_t Print::println() {
+	return this->write('\r') + this->write('\n');
+}
+
+size_t Print::printNumber(unsigned long value, uint8_t base) {
+	char buffer[8 * sizeof(unsigned long) + 1];
+	char *str = &buffer[sizeof(buffer) - 1];
+	*str = '\0';
+
+	if (base < 2) {
+		base = 10;
+	}
+
+	do {
+		uint8_t digit = value % base;
+		*--str = digit < 10 ? '0' + digit : 'A' + digit - 10;
+		value /= base;
+	} while (value != 0);
+
+	return this->write(str);
+}
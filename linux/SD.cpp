@@ -0,0 +1,118 @@
+/*
+SD.cpp
+Implementation of SD library for Linux builds.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "SD.h"
+
+#include <unistd.h>
+
+SDClass SD;
+
+File::File(FILE *file):
+	file(file)
+{}
+
+size_t File::write(uint8_t data) {
+	return this->write(&data, 1);
+}
+
+size_t File::write(const uint8_t *buffer, size_t size) {
+	if (this->file == NULL) { return 0; }
+
+	return fwrite(buffer, 1, size, this->file);
+}
+
+int File::read() {
+	if (this->file == NULL) { return -1; }
+
+	return fgetc(this->file);
+}
+
+int File::read(void *buffer, uint16_t size) {
+	if (this->file == NULL) { return -1; }
+
+	return fread(buffer, 1, size, this->file);
+}
+
+int File::peek() {
+	int c = this->read();
+	if (c != -1) {
+		ungetc(c, this->file);
+	}
+
+	return c;
+}
+
+int File::available() {
+	return this->size() - this->position();
+}
+
+bool File::seek(uint32_t position) {
+	if (this->file == NULL) { return false; }
+
+	return fseek(this->file, position, SEEK_SET) == 0;
+}
+
+uint32_t File::position() {
+	if (this->file == NULL) { return 0; }
+
+	return ftell(this->file);
+}
+
+uint32_t File::size() {
+	if (this->file == NULL) { return 0; }
+
+	long position = ftell(this->file);
+	fseek(this->file, 0, SEEK_END);
+	long size = ftell(this->file);
+	fseek(this->file, position, SEEK_SET);
+
+	return size;
+}
+
+void File::flush() {
+	if (this->file != NULL) {
+		fflush(this->file);
+	}
+}
+
+void File::close() {
+	if (this->file != NULL) {
+		fclose(this->file);
+		this->file = NULL;
+	}
+}
+
+File::operator bool() const {
+	return this->file != NULL;
+}
+
+bool SDClass::begin(uint8_t chipSelect) {
+	return true;
+}
+
+File SDClass::open(const char *path, uint8_t mode) {
+	return File(fopen(path, mode == FILE_WRITE ? "a+b" : "rb"));
+}
+
+bool SDClass::exists(const char *path) {
+	return access(path, F_OK) == 0;
+}
+
+bool SDClass::remove(const char *path) {
+	return unlink(path) == 0;
+}
@@ -0,0 +1,57 @@
+/*
+SD.h
+Arduino SD library for Linux builds, files are opened in local file system.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+
+class File {
+public:
+	File(FILE *file = NULL);
+
+	size_t write(uint8_t data);
+	size_t write(const uint8_t *buffer, size_t size);
+	int read(); // -1 at end of file
+	int read(void *buffer, uint16_t size);
+	int peek();
+	int available();
+	bool seek(uint32_t position);
+	uint32_t position();
+	uint32_t size();
+	void flush();
+	void close();
+
+	operator bool() const;
+
+private:
+	FILE *file;
+};
+
+class SDClass {
+public:
+	bool begin(uint8_t chipSelect = 0); // Always succeeds, files are local
+	File open(const char *path, uint8_t mode = FILE_READ); // FILE_WRITE creates file and appends to it, like on Arduino
+	bool exists(const char *path);
+	bool remove(const char *path);
+};
+
+extern SDClass SD;
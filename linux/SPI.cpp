@@ -0,0 +1,253 @@
+/*
+SPI.cpp
+Implementation of SPIClass for Linux builds.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#include "SPI.h"
+#include "Arduino.h"
+
+#include <stdio.h>
+
+SPIClass SPI;
+
+SPIClass::SPIClass():
+	bus(NULL),
+	buffer(NULL),
+	capacity(0),
+	length(0),
+	size(0),
+	count(0),
+	selected(false),
+	open(false),
+	external(false),
+	held(false),
+	messages(0),
+	bytes(0)
+{}
+
+SPIClass::~SPIClass() {
+	free(this->buffer);
+}
+
+void SPIClass::begin() {
+	if (this->bus == NULL) {
+		fprintf(stderr, "ILI9486: SPI.setBus must be called before display is created\n");
+		abort();
+	}
+}
+
+void SPIClass::end() {
+	this->flush();
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+	// Only reads are issued with data / command pin high and single byte transfers
+	if (this->bus->getPin(this->bus->getDataCommand()) == HIGH) {
+		uint8_t received = 0;
+		this->exchange(&data, &received, 1);
+		return received;
+	}
+
+	this->queue(&data, 1);
+	return 0;
+}
+
+uint16_t SPIClass::transfer16(uint16_t data) {
+	// Most significant byte first, like on Arduino
+	uint8_t word[2] = {(uint8_t)(data >> 8), (uint8_t)data};
+	this->queue(word, 2);
+	return 0;
+}
+
+void SPIClass::transfer(void *buffer, size_t count) {
+	this->exchange((uint8_t*)buffer, (uint8_t*)buffer, count);
+}
+
+uint8_t *SPIClass::reserve(uint32_t count) {
+	if (this->capacity - this->size < count || this->isFull()) {
+		this->flush();
+	}
+
+	// Reserved bytes extend current transfer like queued ones
+	if (!this->open || this->external) {
+		this->startTransfer();
+	}
+
+	uint8_t *memory = this->buffer + this->length;
+	this->transfers[this->count - 1].len += count;
+	this->length += count;
+	this->size += count;
+
+	return memory;
+}
+
+void SPIClass::write(const void *buffer, uint32_t count) {
+	const uint8_t *data = (const uint8_t*)buffer;
+
+	// Every part becomes transfer of current chip select period, spidev limits only size of message
+	while (count > 0) {
+		if (this->size == this->capacity || this->count == ILI9486_SPI_TRANSFERS) {
+			this->flush();
+		}
+
+		uint32_t chunk = this->capacity - this->size;
+		if (chunk > count) {
+			chunk = count;
+		}
+
+		struct spi_ioc_transfer *transfer = &this->transfers[this->count++];
+		memset(transfer, 0, sizeof(*transfer));
+		transfer->tx_buf = (uintptr_t)data;
+		transfer->len = chunk;
+		transfer->speed_hz = this->bus->getSpeed();
+		transfer->bits_per_word = 8;
+		this->open = true;
+		this->external = true;
+
+		this->size += chunk;
+		data += chunk;
+		count -= chunk;
+	}
+}
+
+uint32_t SPIClass::getMessageSize() {
+	return this->capacity;
+}
+
+void SPIClass::setBus(ILI9486Bus *bus) {
+	this->flush();
+
+	this->bus = bus;
+	this->capacity = bus->getMessageSize();
+	this->buffer = (uint8_t*)realloc(this->buffer, this->capacity);
+}
+
+ILI9486Bus *SPIClass::getBus() {
+	return this->bus;
+}
+
+void SPIClass::select(bool selected) {
+	if (!selected) {
+		if (this->open) {
+			// Chip is deselected after this transfer, next one starts new transaction
+			this->transfers[this->count - 1].cs_change = 1;
+		} else if (this->held) {
+			// Transaction ended by immediate transfer is closed with empty transfer
+			struct spi_ioc_transfer release;
+			memset(&release, 0, sizeof(release));
+			release.speed_hz = this->bus->getSpeed();
+			release.bits_per_word = 8;
+			this->send(&release, 1, false);
+		}
+	}
+
+	this->selected = selected;
+	this->open = false;
+}
+
+void SPIClass::flush() {
+	if (this->count == 0) { return; }
+
+	// Transaction still in progress keeps chip selected until next message
+	this->send(this->transfers, this->count, this->selected && this->open);
+
+	this->count = 0;
+	this->length = 0;
+	this->size = 0;
+	this->open = false;
+}
+
+uint32_t SPIClass::getMessages() {
+	return this->messages;
+}
+
+uint64_t SPIClass::getBytes() {
+	return this->bytes;
+}
+
+void SPIClass::queue(const uint8_t *data, uint32_t count) {
+	while (count > 0) {
+		if (this->size == this->capacity || this->isFull()) {
+			this->flush();
+		}
+
+		if (!this->open || this->external) {
+			this->startTransfer();
+		}
+
+		uint32_t chunk = this->capacity - this->size;
+		if (chunk > count) {
+			chunk = count;
+		}
+
+		memcpy(this->buffer + this->length, data, chunk);
+		this->transfers[this->count - 1].len += chunk;
+		this->length += chunk;
+		this->size += chunk;
+		data += chunk;
+		count -= chunk;
+	}
+}
+
+void SPIClass::startTransfer() {
+	struct spi_ioc_transfer *transfer = &this->transfers[this->count++];
+	memset(transfer, 0, sizeof(*transfer));
+	transfer->tx_buf = (uintptr_t)(this->buffer + this->length);
+	transfer->speed_hz = this->bus->getSpeed();
+	transfer->bits_per_word = 8;
+	this->open = true;
+	this->external = false;
+}
+
+bool SPIClass::isFull() {
+	// New transfer is needed when there is no open one in buffer
+	return (!this->open || this->external) && this->count == ILI9486_SPI_TRANSFERS;
+}
+
+void SPIClass::exchange(uint8_t *tx, uint8_t *rx, uint32_t count) {
+	// Queued bytes go first, chip stays selected for this transfer
+	this->flush();
+
+	while (count > 0) {
+		uint32_t chunk = count < this->capacity ? count : this->capacity;
+
+		struct spi_ioc_transfer transfer;
+		memset(&transfer, 0, sizeof(transfer));
+		transfer.tx_buf = (uintptr_t)tx;
+		transfer.rx_buf = (uintptr_t)rx;
+		transfer.len = chunk;
+		transfer.speed_hz = this->bus->getSpeed();
+		transfer.bits_per_word = 8;
+		this->send(&transfer, 1, this->selected);
+
+		tx += chunk;
+		rx += chunk;
+		count -= chunk;
+	}
+}
+
+bool SPIClass::send(struct spi_ioc_transfer *transfers, uint32_t count, bool hold) {
+	// Value of cs_change of last transfer is inverted: set keeps chip selected after message
+	transfers[count - 1].cs_change = hold ? 1 : 0;
+	this->held = hold;
+
+	this->messages++;
+	for (uint32_t i = 0; i < count; i++) {
+		this->bytes += transfers[i].len;
+	}
+
+	return this->bus->message(transfers, count);
+}
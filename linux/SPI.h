@@ -0,0 +1,82 @@
+/*
+SPI.h
+Arduino SPI class for Linux builds. Written bytes are queued and sent in large
+messages, transactions marked with chip select pin are chained with cs_change.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <linux/spi/spidev.h>
+
+#include "ILI9486Bus.h"
+
+// Maximum number of transfers in one message, limited by size field of ioctl number
+#define ILI9486_SPI_TRANSFERS 256
+
+// Bytes can be written directly to queue with SPI.reserve or queued without copying with SPI.write
+#define ILI9486_SPI_STAGING
+
+class SPIClass {
+public:
+	SPIClass();
+	~SPIClass();
+
+	void begin();
+	void end(); // Send queued bytes
+
+	uint8_t transfer(uint8_t data); // Reads (data / command pin high) are executed immediately, commands are queued and return 0
+	uint16_t transfer16(uint16_t data); // Queued, returns 0
+	void transfer(void *buffer, size_t count); // Executed immediately, received bytes replace buffer
+	uint8_t *reserve(uint32_t count); // Queue count bytes which caller writes to returned memory, count can't exceed getMessageSize
+	void write(const void *buffer, uint32_t count); // Queue bytes without copying, buffer must stay unchanged until flush
+	uint32_t getMessageSize();
+
+	void setBus(ILI9486Bus *bus); // Must be called before display is created
+	ILI9486Bus *getBus();
+
+	void select(bool selected); // Chip select pin was written
+	void flush(); // Send queued bytes as one message
+
+	uint32_t getMessages(); // Number of messages sent to bus
+	uint64_t getBytes(); // Number of bytes sent to bus
+
+private:
+	void queue(const uint8_t *data, uint32_t count);
+	void startTransfer(); // Start transfer at the end of buffer, it continues current chip select period if it is open
+	bool isFull(); // No transfer can be started
+	void exchange(uint8_t *tx, uint8_t *rx, uint32_t count); // Transfer which needs received bytes
+	bool send(struct spi_ioc_transfer *transfers, uint32_t count, bool hold); // hold keeps chip selected after message
+
+	ILI9486Bus *bus;
+	uint8_t *buffer; // Queued bytes
+	uint32_t capacity;
+	uint32_t length; // Bytes used in buffer
+	uint32_t size; // Bytes of queued message, includes bytes queued without copying
+	struct spi_ioc_transfer transfers[ILI9486_SPI_TRANSFERS]; // Queued transfers, one for every chip select period
+	uint32_t count;
+
+	bool selected; // Chip select pin is low
+	bool open; // Last queued transfer belongs to current chip select period
+	bool external; // Last queued transfer points to memory of caller
+	bool held; // Chip was left selected after last message
+
+	uint32_t messages;
+	uint64_t bytes;
+};
+
+extern SPIClass SPI;
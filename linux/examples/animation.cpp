@@ -0,0 +1,127 @@
+/*
+animation.cpp
+Plays delta-frame animation made by encoder example from file and prints
+achieved frame rate and amount of data sent to display.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+animation FILE [--position X,Y] [--repeat N] [--loopback] [--device /dev/spidev0.0] [--gpio /dev/gpiochip0] [--speed 32000000]
+
+Pins are the same as in benchmark example.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ILI9486.h>
+#include <ILI9486Animation.h>
+#include <ILI9486SpidevBus.h>
+#include <ILI9486LoopbackBus.h>
+
+#define CS 8
+#define BL 18
+#define RST 25
+#define DC 24
+
+int main(int argc, char **argv) {
+	const char *path = NULL;
+	const char *device = "/dev/spidev0.0";
+	const char *gpio = "/dev/gpiochip0";
+	uint32_t speed = 32000000;
+	uint32_t x = 0, y = 0;
+	uint32_t repeat = 1;
+	bool loopback = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--position") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%u,%u", &x, &y);
+		} else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+			repeat = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--loopback") == 0) {
+			loopback = true;
+		} else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+			device = argv[++i];
+		} else if (strcmp(argv[i], "--gpio") == 0 && i + 1 < argc) {
+			gpio = argv[++i];
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else if (argv[i][0] != '-' && path == NULL) {
+			path = argv[i];
+		} else {
+			path = NULL;
+			break;
+		}
+	}
+
+	if (path == NULL) {
+		fprintf(stderr, "usage: %s FILE [--position X,Y] [--repeat N] [--loopback] [--device PATH] [--gpio PATH] [--speed HZ]\n", argv[0]);
+		return 1;
+	}
+
+	ILI9486Bus *bus;
+	if (loopback) {
+		bus = new ILI9486LoopbackBus(CS, DC, speed);
+	} else {
+		ILI9486SpidevBus *spidev = new ILI9486SpidevBus(device, gpio, CS, DC, speed);
+		if (!spidev->isOpen()) { return 1; }
+		bus = spidev;
+	}
+
+	SPI.setBus(bus);
+	ILI9486 display(CS, BL, RST, DC, ILI9486::L2R_U2D, 255);
+
+	File file = SD.open(path);
+	if (!file) {
+		perror(path);
+		return 1;
+	}
+
+	ILI9486Animation animation(&display, file);
+	if (!animation.isValid()) {
+		fprintf(stderr, "%s: not an animation file\n", path);
+		return 1;
+	}
+
+	printf("%s: %u frames %ux%u, %u ms per frame\n", path, animation.getFrames(), animation.getWidth(), animation.getHeight(), animation.getFrameTime());
+
+	// Animation is paced by update, like in loop() of Arduino sketch
+	uint32_t frames = animation.getFrames() * repeat;
+	uint32_t shown = 0;
+	uint64_t pixels = 0;
+	uint64_t bytes = SPI.getBytes();
+	unsigned long start = micros();
+
+	while (shown < frames) {
+		if (animation.update(x, y)) {
+			SPI.flush();
+			pixels += animation.getFramePixels();
+			shown++;
+		} else {
+			delay(1);
+		}
+	}
+
+	double seconds = (micros() - start) / 1e6;
+	uint32_t area = (uint32_t)animation.getWidth() * animation.getHeight();
+	printf("%u frames in %.2f s, %.1f fps, %.1f%% of pixels written per frame, %.1f kB/s sent\n",
+		shown, seconds, shown / seconds, 100.0 * pixels / ((uint64_t)shown * area), (SPI.getBytes() - bytes) / 1024.0 / seconds);
+
+	file.close();
+	delete bus;
+	return 0;
+}
@@ -0,0 +1,128 @@
+/*
+benchmark.cpp
+Measures full frame write speed of ILI9486 library on Linux,
+with real display on spidev or with simulated display.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+EXAMPLE SETUP (Raspberry Pi, BCM numbering):
+CE0 (8) <-> CS
+18 <-> BL
+25 <-> RST
+24 <-> DC
+
+Usage:
+benchmark [--loopback] [--device /dev/spidev0.0] [--gpio /dev/gpiochip0] [--speed 32000000] [--frames 20]
+
+Raise spidev buffer (spidev.bufsiz=65536 in kernel command line), so one message carries 32768 pixels.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ILI9486.h>
+#include <ILI9486SpidevBus.h>
+#include <ILI9486LoopbackBus.h>
+
+#define CS 8
+#define BL 18
+#define RST 25
+#define DC 24
+
+static void report(const char *name, uint32_t frames, unsigned long time, uint64_t bytes, uint32_t speed) {
+	double seconds = time / 1e6;
+	printf("%-12s %6.1f fps %8.2f MB/s", name, frames / seconds, bytes / seconds / 1e6);
+
+	// Share of SPI clock spent on data
+	if (speed != 0) {
+		printf(" %5.1f%% of link", 100.0 * bytes * 8 / seconds / speed);
+	}
+
+	printf("\n");
+}
+
+int main(int argc, char **argv) {
+	const char *device = "/dev/spidev0.0";
+	const char *gpio = "/dev/gpiochip0";
+	uint32_t speed = 32000000;
+	uint32_t frames = 20;
+	bool loopback = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--loopback") == 0) {
+			loopback = true;
+		} else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+			device = argv[++i];
+		} else if (strcmp(argv[i], "--gpio") == 0 && i + 1 < argc) {
+			gpio = argv[++i];
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			frames = strtoul(argv[++i], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [--loopback] [--device PATH] [--gpio PATH] [--speed HZ] [--frames N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	ILI9486Bus *bus;
+	if (loopback) {
+		// Simulated link of given speed, 0 measures library alone
+		bus = new ILI9486LoopbackBus(CS, DC, speed);
+	} else {
+		ILI9486SpidevBus *spidev = new ILI9486SpidevBus(device, gpio, CS, DC, speed);
+		if (!spidev->isOpen()) { return 1; }
+		bus = spidev;
+	}
+
+	SPI.setBus(bus);
+	ILI9486 display(CS, BL, RST, DC, ILI9486::L2R_U2D, 255);
+
+	uint32_t size = display.getSize();
+	ILI9486_COLOR *frame = new ILI9486_COLOR[size];
+	for (uint32_t i = 0; i < size; i++) {
+		frame[i] = i * 7;
+	}
+
+	// Every frame is one window, bytes are counted without window commands
+	unsigned long start = micros();
+	for (uint32_t i = 0; i < frames; i++) {
+		display.clear(i & 1 ? ILI9486_WHITE : ILI9486_BLACK);
+	}
+	SPI.flush();
+	report("fill", frames, micros() - start, (uint64_t)frames * size * 2, speed);
+
+	start = micros();
+	for (uint32_t i = 0; i < frames; i++) {
+		display.openWindow(0, 0, display.getWidth(), display.getHeight());
+		display.writeBuffer(frame, size);
+	}
+	SPI.flush();
+	report("writeBuffer", frames, micros() - start, (uint64_t)frames * size * 2, speed);
+
+	printf("%u messages, %.1f kB per message\n", SPI.getMessages(), SPI.getBytes() / 1024.0 / SPI.getMessages());
+
+	// Last frame read back through memory read command
+	ILI9486_COLOR line[64];
+	display.saveRegion(0, 100, 64, 101, line);
+	bool match = memcmp(line, frame + 100 * display.getWidth(), sizeof(line)) == 0;
+	printf("read back: %s\n", match ? "ok" : "mismatch");
+
+	delete[] frame;
+	delete bus;
+	return 0;
+}
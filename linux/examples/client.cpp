@@ -0,0 +1,126 @@
+/*
+client.cpp
+Client of compositor example, draws square bouncing in its surface. Only
+previous and new position of square are submitted as damage, so several
+clients can animate at once while compositor sends only changed pixels.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+client [--socket /tmp/ili9486.sock] [--position X,Y] [--size WxH] [--z N] [--color COLOR] [--fps 30] [--frames N]
+
+Colors are RGB565 in hex, 0 frames animate until interrupted.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <ILI9486.h>
+#include <ILI9486Compositor.h>
+
+#define SQUARE 24
+
+static volatile bool running = true;
+
+static void stop(int signal) {
+	running = false;
+}
+
+static void fill(ILI9486Surface *surface, int16_t x, int16_t y, uint16_t width, uint16_t height, ILI9486_COLOR color) {
+	ILI9486_COLOR *pixels = surface->getPixels();
+	for (uint16_t row = y; row < y + height; row++) {
+		for (uint16_t column = x; column < x + width; column++) {
+			pixels[(uint32_t)row * surface->getWidth() + column] = color;
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	const char *path = "/tmp/ili9486.sock";
+	int32_t x = 0, y = 0, z = 0;
+	uint32_t width = 160, height = 120;
+	uint32_t fps = 30;
+	uint32_t frames = 0;
+	ILI9486_COLOR color = 0x07E0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+			path = argv[++i];
+		} else if (strcmp(argv[i], "--position") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%d,%d", &x, &y);
+		} else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%ux%u", &width, &height);
+		} else if (strcmp(argv[i], "--z") == 0 && i + 1 < argc) {
+			z = strtol(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--color") == 0 && i + 1 < argc) {
+			color = strtoul(argv[++i], NULL, 16);
+		} else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+			fps = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			frames = strtoul(argv[++i], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [--socket PATH] [--position X,Y] [--size WxH] [--z N] [--color COLOR] [--fps N] [--frames N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (width < SQUARE || height < SQUARE) {
+		fprintf(stderr, "surface must be at least %ux%u\n", SQUARE, SQUARE);
+		return 1;
+	}
+
+	if (fps == 0) {
+		fps = 1;
+	}
+
+	ILI9486Surface surface;
+	if (!surface.connect(path, x, y, width, height, z)) { return 1; }
+
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+
+	// Frame around surface shows its bounds
+	ILI9486_COLOR background = (color >> 2) & 0x39E7;
+	fill(&surface, 0, 0, width, height, color);
+	fill(&surface, 1, 1, width - 2, height - 2, background);
+	surface.damage();
+
+	int16_t squareX = 1, squareY = 1;
+	int16_t stepX = 3, stepY = 2;
+
+	for (uint32_t frame = 0; running && (frames == 0 || frame < frames); frame++) {
+		int16_t previousX = squareX, previousY = squareY;
+
+		if (squareX + stepX < 1 || squareX + stepX + SQUARE > (int32_t)width - 1) { stepX = -stepX; }
+		if (squareY + stepY < 1 || squareY + stepY + SQUARE > (int32_t)height - 1) { stepY = -stepY; }
+		squareX += stepX;
+		squareY += stepY;
+
+		// Pixels are drawn first, damage publishes them
+		fill(&surface, previousX, previousY, SQUARE, SQUARE, background);
+		fill(&surface, squareX, squareY, SQUARE, SQUARE, color);
+		surface.damage(previousX, previousY, SQUARE, SQUARE);
+		surface.damage(squareX, squareY, SQUARE, SQUARE);
+
+		usleep(1000000 / fps);
+	}
+
+	surface.disconnect();
+	return 0;
+}
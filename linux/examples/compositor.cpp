@@ -0,0 +1,127 @@
+/*
+compositor.cpp
+Daemon owning display, client processes (like client example) draw into their
+own surfaces and only damaged parts of screen are sent. Statistics are printed
+every second.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+compositor [--socket /tmp/ili9486.sock] [--background COLOR] [--quiet]
+           [--loopback [--gram PATH]] [--device /dev/spidev0.0] [--gpio /dev/gpiochip0] [--speed 32000000]
+
+Background is RGB565 color in hex. With --gram GRAM of loopback bus is kept in file, so result can be inspected.
+Pins are the same as in benchmark example.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#include <ILI9486.h>
+#include <ILI9486Compositor.h>
+#include <ILI9486SpidevBus.h>
+#include <ILI9486LoopbackBus.h>
+
+#define CS 8
+#define BL 18
+#define RST 25
+#define DC 24
+
+static volatile bool running = true;
+
+static void stop(int signal) {
+	running = false;
+}
+
+int main(int argc, char **argv) {
+	const char *path = "/tmp/ili9486.sock";
+	const char *gram = NULL;
+	const char *device = "/dev/spidev0.0";
+	const char *gpio = "/dev/gpiochip0";
+	uint32_t speed = 32000000;
+	ILI9486_COLOR background = ILI9486_BLACK;
+	bool loopback = false;
+	bool quiet = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+			path = argv[++i];
+		} else if (strcmp(argv[i], "--background") == 0 && i + 1 < argc) {
+			background = strtoul(argv[++i], NULL, 16);
+		} else if (strcmp(argv[i], "--quiet") == 0) {
+			quiet = true;
+		} else if (strcmp(argv[i], "--loopback") == 0) {
+			loopback = true;
+		} else if (strcmp(argv[i], "--gram") == 0 && i + 1 < argc) {
+			gram = argv[++i];
+		} else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+			device = argv[++i];
+		} else if (strcmp(argv[i], "--gpio") == 0 && i + 1 < argc) {
+			gpio = argv[++i];
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [--socket PATH] [--background COLOR] [--quiet]\n"
+				"       [--loopback [--gram PATH]] [--device PATH] [--gpio PATH] [--speed HZ]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	ILI9486Bus *bus;
+	if (loopback) {
+		bus = new ILI9486LoopbackBus(CS, DC, speed, gram);
+	} else {
+		ILI9486SpidevBus *spidev = new ILI9486SpidevBus(device, gpio, CS, DC, speed);
+		if (!spidev->isOpen()) { return 1; }
+		bus = spidev;
+	}
+
+	SPI.setBus(bus);
+	ILI9486 display(CS, BL, RST, DC, ILI9486::L2R_U2D, 255);
+
+	ILI9486Compositor compositor(&display, path, background);
+	if (!compositor.isOpen()) { return 1; }
+
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+
+	// Statistics are printed once per second when anything was sent
+	ILI9486CompositorStats last;
+	compositor.getStats(&last);
+	unsigned long report = micros();
+
+	while (running) {
+		compositor.update(100);
+
+		ILI9486CompositorStats stats;
+		compositor.getStats(&stats);
+		unsigned long now = micros();
+
+		if (!quiet && now - report >= 1000000UL && stats.updates != last.updates) {
+			printf("%u clients, %u updates, %u rectangles, %llu px sent, last composite %u us\n",
+				stats.clients, stats.updates - last.updates, stats.rectangles - last.rectangles,
+				(unsigned long long)(stats.pixels - last.pixels), stats.compositeTime);
+			fflush(stdout);
+			last = stats;
+			report = now;
+		}
+	}
+
+	delete bus;
+	return 0;
+}
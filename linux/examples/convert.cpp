@@ -0,0 +1,112 @@
+/*
+convert.cpp
+Measures conversion speed of ILI9486Converter kernels in megapixels per second
+and checks that vector kernels give the same colors as scalar one.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+convert [--frames 200] [--speed 32000000]
+
+Link speed is only used to express results as multiple of pixel rate of SPI link.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ILI9486.h>
+#include <ILI9486Converter.h>
+
+#define WIDTH ILI9486_SHORT_SIDE
+#define HEIGHT ILI9486_LONG_SIDE
+
+static const char *formatNames[] = {"RGB888", "XRGB8888"};
+static const char *ditherNames[] = {"none", "ordered", "diffusion"};
+
+// Converts frames and returns megapixels per second, result receives last frame
+static double measure(ILI9486Converter *converter, const uint8_t *image, uint8_t step, uint32_t frames, ILI9486_COLOR *result) {
+	unsigned long start = micros();
+
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		for (uint16_t y = 0; y < HEIGHT; y++) {
+			converter->convert(image + (uint32_t)y * WIDTH * step, result + (uint32_t)y * WIDTH, WIDTH, 0, y);
+		}
+	}
+
+	unsigned long time = micros() - start;
+	return (double)frames * WIDTH * HEIGHT / time;
+}
+
+int main(int argc, char **argv) {
+	uint32_t frames = 200;
+	uint32_t speed = 32000000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			frames = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [--frames N] [--speed HZ]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// Random image, 4 bytes per pixel is enough for both formats
+	uint8_t *image = new uint8_t[WIDTH * HEIGHT * 4];
+	srand(1);
+	for (uint32_t i = 0; i < WIDTH * HEIGHT * 4; i++) {
+		image[i] = rand();
+	}
+
+	ILI9486_COLOR *expected = new ILI9486_COLOR[WIDTH * HEIGHT];
+	ILI9486_COLOR *result = new ILI9486_COLOR[WIDTH * HEIGHT];
+	double link = speed / 16.0 / 1e6;
+	bool ok = true;
+
+	printf("%-9s %-9s %-6s %10s %8s\n", "format", "dither", "kernel", "MP/s", "x link");
+
+	for (uint8_t format = ILI9486Converter::RGB888; format <= ILI9486Converter::XRGB8888; format++) {
+		uint8_t step = format == ILI9486Converter::RGB888 ? 3 : 4;
+
+		for (uint8_t dither = ILI9486Converter::NO_DITHER; dither <= ILI9486Converter::DIFFUSION_DITHER; dither++) {
+			for (uint8_t kernel = ILI9486Converter::SCALAR; kernel <= ILI9486Converter::NEON; kernel++) {
+				if (!ILI9486Converter::isSupported((ILI9486Converter::Kernel)kernel)) { continue; }
+
+				// Diffusion always runs scalar kernel
+				if (dither == ILI9486Converter::DIFFUSION_DITHER && kernel != ILI9486Converter::SCALAR) { continue; }
+
+				ILI9486Converter converter((ILI9486Converter::Format)format, (ILI9486Converter::Dither)dither, WIDTH);
+				converter.setKernel((ILI9486Converter::Kernel)kernel);
+
+				double rate = measure(&converter, image, step, frames, kernel == ILI9486Converter::SCALAR ? expected : result);
+				bool same = kernel == ILI9486Converter::SCALAR || memcmp(expected, result, WIDTH * HEIGHT * sizeof(ILI9486_COLOR)) == 0;
+				ok = ok && same;
+
+				printf("%-9s %-9s %-6s %10.1f %8.1f%s\n", formatNames[format], ditherNames[dither],
+					ILI9486Converter::getKernelName((ILI9486Converter::Kernel)kernel), rate, rate / link, same ? "" : " MISMATCH");
+			}
+		}
+	}
+
+	printf("kernels %s\n", ok ? "match" : "differ");
+
+	delete[] image;
+	delete[] expected;
+	delete[] result;
+	return ok ? 0 : 1;
+}
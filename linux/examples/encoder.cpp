@@ -0,0 +1,313 @@
+/*
+encoder.cpp
+Encodes RGB565 video into delta-frame animation played by ILI9486Animation.
+Every frame stores only rectangles changed since previous frame, their pixels
+are run-length encoded. Output is binary file (for SD card or Linux) or C header
+with PROGMEM array.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+encoder INPUT OUTPUT [--raw WxH] [--little-endian] [--fps N] [--header NAME]
+
+INPUT is framed video of ILI9486Video or, with --raw, file of big endian frames without header.
+With --header OUTPUT is C header defining PROGMEM array NAME.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ILI9486.h>
+#include <ILI9486Animation.h>
+#include <ILI9486Video.h>
+
+// Changes are found in tiles of this size, adjacent changed tiles form rectangles
+#define TILE 16
+
+// Growing output buffer
+struct Output {
+	uint8_t *data;
+	uint32_t length;
+	uint32_t capacity;
+};
+
+static void putByte(Output *output, uint8_t value) {
+	if (output->length == output->capacity) {
+		output->capacity = output->capacity ? output->capacity * 2 : 65536;
+		output->data = (uint8_t*)realloc(output->data, output->capacity);
+	}
+	output->data[output->length++] = value;
+}
+
+static void putWord(Output *output, uint16_t value) {
+	putByte(output, value);
+	putByte(output, value >> 8);
+}
+
+// Rectangle in tiles while rectangles are built, then in pixels
+struct Rectangle {
+	uint16_t x0, y0, x1, y1; // Exclusive end
+};
+
+static void encodeRectangle(Output *output, const uint16_t *frame, uint16_t width, const Rectangle *r) {
+	putWord(output, r->x0);
+	putWord(output, r->y0);
+	putWord(output, r->x1 - r->x0);
+	putWord(output, r->y1 - r->y0);
+
+	// Pixels in window order, runs may continue across rows
+	uint32_t n = (uint32_t)(r->x1 - r->x0) * (r->y1 - r->y0);
+	uint16_t rowWidth = r->x1 - r->x0;
+	#define PIXEL(i) frame[(uint32_t)(r->y0 + (i) / rowWidth) * width + r->x0 + (i) % rowWidth]
+
+	uint32_t i = 0;
+	while (i < n) {
+		// Repeated run pays off from 3 equal pixels (3 bytes instead of 6)
+		uint32_t run = 1;
+		while (i + run < n && run < ILI9486_ANIMATION_RUN && PIXEL(i + run) == PIXEL(i)) {
+			run++;
+		}
+
+		if (run >= 3) {
+			putByte(output, ILI9486_ANIMATION_REPEAT | (run - 1));
+			putWord(output, PIXEL(i));
+			i += run;
+			continue;
+		}
+
+		// Literal run ends where repeated run of 3 pixels starts
+		uint32_t literal = 0;
+		while (i + literal < n && literal < ILI9486_ANIMATION_RUN) {
+			uint32_t j = i + literal;
+			if (j + 2 < n && PIXEL(j) == PIXEL(j + 1) && PIXEL(j) == PIXEL(j + 2)) { break; }
+			literal++;
+		}
+
+		putByte(output, literal - 1);
+		for (uint32_t j = 0; j < literal; j++) {
+			putWord(output, PIXEL(i + j));
+		}
+		i += literal;
+	}
+
+	#undef PIXEL
+}
+
+// Finds rectangles covering pixels which differ between frames, returns their number
+static uint32_t findRectangles(const uint16_t *previous, const uint16_t *frame, uint16_t width, uint16_t height, Rectangle *rectangles) {
+	uint16_t tilesX = (width + TILE - 1) / TILE;
+	uint16_t tilesY = (height + TILE - 1) / TILE;
+	uint32_t count = 0;
+
+	for (uint16_t ty = 0; ty < tilesY; ty++) {
+		uint16_t tx = 0;
+
+		while (tx < tilesX) {
+			// Run of changed tiles in this tile row
+			uint16_t start = tx;
+			while (tx < tilesX) {
+				bool changed = false;
+				for (uint16_t y = ty * TILE; y < ty * TILE + TILE && y < height && !changed; y++) {
+					uint32_t offset = (uint32_t)y * width + tx * TILE;
+					uint16_t n = tx * TILE + TILE <= width ? TILE : width - tx * TILE;
+					changed = memcmp(previous + offset, frame + offset, n * 2) != 0;
+				}
+				if (!changed) { break; }
+				tx++;
+			}
+
+			if (tx > start) {
+				// Rectangle of previous tile row with the same columns grows down, otherwise new one starts
+				uint32_t i;
+				for (i = 0; i < count; i++) {
+					if (rectangles[i].x0 == start && rectangles[i].x1 == tx && rectangles[i].y1 == ty) { break; }
+				}
+
+				if (i < count) {
+					rectangles[i].y1 = ty + 1;
+				} else {
+					Rectangle r = {start, ty, tx, (uint16_t)(ty + 1)};
+					rectangles[count++] = r;
+				}
+			} else {
+				tx++;
+			}
+		}
+	}
+
+	// Tiles are converted to pixels and shrunk to bounding box of changes
+	for (uint32_t i = 0; i < count; i++) {
+		Rectangle *r = &rectangles[i];
+		uint16_t x0 = r->x0 * TILE, y0 = r->y0 * TILE;
+		uint16_t x1 = r->x1 * TILE < width ? r->x1 * TILE : width;
+		uint16_t y1 = r->y1 * TILE < height ? r->y1 * TILE : height;
+		Rectangle box = {x1, y1, x0, y0};
+
+		for (uint16_t y = y0; y < y1; y++) {
+			for (uint16_t x = x0; x < x1; x++) {
+				uint32_t offset = (uint32_t)y * width + x;
+				if (previous[offset] == frame[offset]) { continue; }
+				if (x < box.x0) { box.x0 = x; }
+				if (y < box.y0) { box.y0 = y; }
+				if (x + 1 > box.x1) { box.x1 = x + 1; }
+				if (y + 1 > box.y1) { box.y1 = y + 1; }
+			}
+		}
+
+		*r = box;
+	}
+
+	return count;
+}
+
+int main(int argc, char **argv) {
+	const char *input = NULL;
+	const char *output = NULL;
+	const char *name = NULL;
+	uint32_t width = 0, height = 0;
+	uint32_t fps = 0;
+	bool raw = false;
+	bool bigEndian = true;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--raw") == 0 && i + 1 < argc) {
+			raw = sscanf(argv[++i], "%ux%u", &width, &height) == 2;
+		} else if (strcmp(argv[i], "--little-endian") == 0) {
+			bigEndian = false;
+		} else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+			fps = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--header") == 0 && i + 1 < argc) {
+			name = argv[++i];
+		} else if (argv[i][0] != '-' && input == NULL) {
+			input = argv[i];
+		} else if (argv[i][0] != '-' && output == NULL) {
+			output = argv[i];
+		} else {
+			output = NULL;
+			break;
+		}
+	}
+
+	if (input == NULL || output == NULL) {
+		fprintf(stderr, "usage: %s INPUT OUTPUT [--raw WxH] [--little-endian] [--fps N] [--header NAME]\n", argv[0]);
+		return 1;
+	}
+
+	FILE *file = fopen(input, "rb");
+	if (file == NULL) {
+		perror(input);
+		return 1;
+	}
+
+	uint32_t frames = 0xFFFF;
+	if (!raw) {
+		ILI9486VideoHeader header;
+		if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, ILI9486_VIDEO_MAGIC, 4) != 0) {
+			fprintf(stderr, "%s: not a video file, use --raw for frames without header\n", input);
+			return 1;
+		}
+		width = header.width;
+		height = header.height;
+		frames = header.frames;
+		bigEndian = (header.flags & ILI9486_VIDEO_BIG_ENDIAN) != 0;
+		if (fps == 0) {
+			fps = header.fps;
+		}
+	}
+
+	if (fps == 0) {
+		fps = 30;
+	}
+
+	uint32_t pixels = width * height;
+	uint16_t *previous = new uint16_t[pixels];
+	uint16_t *frame = new uint16_t[pixels];
+	Rectangle *rectangles = new Rectangle[((width + TILE - 1) / TILE) * ((height + TILE - 1) / TILE)];
+
+	Output result = {NULL, 0, 0};
+	for (uint8_t i = 0; i < 4; i++) {
+		putByte(&result, ILI9486_ANIMATION_MAGIC[i]);
+	}
+	putWord(&result, width);
+	putWord(&result, height);
+	putWord(&result, 0); // Number of frames is filled at the end
+	putWord(&result, 1000 / fps);
+
+	uint32_t count = 0;
+	uint64_t changed = 0;
+
+	while (count < frames && fread(frame, 2, pixels, file) == pixels) {
+		if (bigEndian) {
+			for (uint32_t i = 0; i < pixels; i++) {
+				frame[i] = (frame[i] >> 8) | (frame[i] << 8);
+			}
+		}
+
+		// First frame is one rectangle covering whole area
+		uint32_t n = 1;
+		if (count == 0) {
+			Rectangle all = {0, 0, (uint16_t)width, (uint16_t)height};
+			rectangles[0] = all;
+		} else {
+			n = findRectangles(previous, frame, width, height, rectangles);
+		}
+
+		putWord(&result, n);
+		for (uint32_t i = 0; i < n; i++) {
+			encodeRectangle(&result, frame, width, &rectangles[i]);
+			changed += (uint32_t)(rectangles[i].x1 - rectangles[i].x0) * (rectangles[i].y1 - rectangles[i].y0);
+		}
+
+		uint16_t *swap = previous;
+		previous = frame;
+		frame = swap;
+		count++;
+	}
+
+	fclose(file);
+	result.data[8] = count;
+	result.data[9] = count >> 8;
+
+	FILE *out = fopen(output, name != NULL ? "w" : "wb");
+	if (out == NULL) {
+		perror(output);
+		return 1;
+	}
+
+	if (name != NULL) {
+		fprintf(out, "// %u frames %ux%u, %u fps\n#pragma once\n#include <Arduino.h>\n\nconst uint8_t %s[%u] PROGMEM = {", count, width, height, fps, name, result.length);
+		for (uint32_t i = 0; i < result.length; i++) {
+			fprintf(out, "%s0x%02X", i == 0 ? "\n\t" : (i % 16 == 0 ? ",\n\t" : ", "), result.data[i]);
+		}
+		fprintf(out, "\n};\n");
+	} else {
+		fwrite(result.data, 1, result.length, out);
+	}
+	fclose(out);
+
+	// Bandwidth needed at given frame rate compared with full frames
+	uint64_t full = (uint64_t)count * pixels * 2;
+	printf("%u frames %ux%u: %u bytes (%.1f%% of raw), %.1f%% of pixels changed, %.1f kB/s at %u fps instead of %.1f kB/s\n",
+		count, width, height, result.length, 100.0 * result.length / full, 100.0 * changed / ((uint64_t)count * pixels),
+		count > 0 ? result.length / 1024.0 * fps / count : 0, fps, pixels * 2 / 1024.0 * fps);
+
+	free(result.data);
+	delete[] previous;
+	delete[] frame;
+	delete[] rectangles;
+	return 0;
+}
@@ -0,0 +1,194 @@
+/*
+mirror.cpp
+Daemon mirroring region of Linux framebuffer (or memory mapped file) on display.
+Only changed areas are sent, every frame with changes is reported.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+mirror [--fb /dev/fb0] [--file PATH --size WxH --format rgb565|xrgb8888] [--region X,Y] [--fps 30] [--quiet]
+       [--loopback] [--device /dev/spidev0.0] [--gpio /dev/gpiochip0] [--speed 32000000]
+
+Pins are the same as in benchmark example.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/fb.h>
+
+#include <ILI9486.h>
+#include <ILI9486Mirror.h>
+#include <ILI9486SpidevBus.h>
+#include <ILI9486LoopbackBus.h>
+
+#define CS 8
+#define BL 18
+#define RST 25
+#define DC 24
+
+static volatile bool running = true;
+
+static void stop(int signal) {
+	running = false;
+}
+
+int main(int argc, char **argv) {
+	const char *framebuffer = "/dev/fb0";
+	const char *file = NULL;
+	const char *device = "/dev/spidev0.0";
+	const char *gpio = "/dev/gpiochip0";
+	uint32_t speed = 32000000;
+	uint32_t fileWidth = 0, fileHeight = 0;
+	uint32_t regionX = 0, regionY = 0;
+	uint32_t fps = 30;
+	ILI9486Mirror::Format format = ILI9486Mirror::RGB565;
+	bool loopback = false;
+	bool quiet = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--fb") == 0 && i + 1 < argc) {
+			framebuffer = argv[++i];
+		} else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+			file = argv[++i];
+		} else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%ux%u", &fileWidth, &fileHeight);
+		} else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			format = strcmp(argv[++i], "xrgb8888") == 0 ? ILI9486Mirror::XRGB8888 : ILI9486Mirror::RGB565;
+		} else if (strcmp(argv[i], "--region") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%u,%u", &regionX, &regionY);
+		} else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+			fps = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--quiet") == 0) {
+			quiet = true;
+		} else if (strcmp(argv[i], "--loopback") == 0) {
+			loopback = true;
+		} else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+			device = argv[++i];
+		} else if (strcmp(argv[i], "--gpio") == 0 && i + 1 < argc) {
+			gpio = argv[++i];
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [--fb PATH] [--file PATH --size WxH --format rgb565|xrgb8888] [--region X,Y] [--fps N] [--quiet]\n"
+				"       [--loopback] [--device PATH] [--gpio PATH] [--speed HZ]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (fps == 0) {
+		fps = 1;
+	}
+
+	// Source is mapped read only, its owner keeps drawing into it
+	uint32_t width, height, stride;
+	int descriptor;
+
+	if (file != NULL) {
+		descriptor = open(file, O_RDONLY);
+		width = fileWidth;
+		height = fileHeight;
+		stride = width * (format == ILI9486Mirror::RGB565 ? 2 : 4);
+	} else {
+		descriptor = open(framebuffer, O_RDONLY);
+
+		struct fb_var_screeninfo var;
+		struct fb_fix_screeninfo fix;
+		if (descriptor < 0 || ioctl(descriptor, FBIOGET_VSCREENINFO, &var) < 0 || ioctl(descriptor, FBIOGET_FSCREENINFO, &fix) < 0) {
+			perror(framebuffer);
+			return 1;
+		}
+
+		if (var.bits_per_pixel != 16 && var.bits_per_pixel != 32) {
+			fprintf(stderr, "%s: %u bits per pixel is not supported\n", framebuffer, var.bits_per_pixel);
+			return 1;
+		}
+
+		width = var.xres;
+		height = var.yres;
+		stride = fix.line_length;
+		format = var.bits_per_pixel == 16 ? ILI9486Mirror::RGB565 : ILI9486Mirror::XRGB8888;
+	}
+
+	if (descriptor < 0) {
+		perror(file != NULL ? file : framebuffer);
+		return 1;
+	}
+
+	size_t size = (size_t)stride * height;
+	const uint8_t *source = (const uint8_t*)mmap(NULL, size, PROT_READ, MAP_SHARED, descriptor, 0);
+	if (source == MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+
+	ILI9486Bus *bus;
+	if (loopback) {
+		bus = new ILI9486LoopbackBus(CS, DC, speed);
+	} else {
+		ILI9486SpidevBus *spidev = new ILI9486SpidevBus(device, gpio, CS, DC, speed);
+		if (!spidev->isOpen()) { return 1; }
+		bus = spidev;
+	}
+
+	SPI.setBus(bus);
+	ILI9486 display(CS, BL, RST, DC, ILI9486::L2R_U2D, 255);
+
+	if (regionX + display.getWidth() > width || regionY + display.getHeight() > height) {
+		fprintf(stderr, "region %ux%u at %u,%u doesn't fit in %ux%u source\n", display.getWidth(), display.getHeight(), regionX, regionY, width, height);
+		return 1;
+	}
+
+	uint8_t bytesPerPixel = format == ILI9486Mirror::RGB565 ? 2 : 4;
+	ILI9486Mirror mirror(&display, source + regionY * stride + regionX * bytesPerPixel, stride, format);
+
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+
+	// Frames start at fixed period, late frame starts immediately
+	unsigned long period = 1000000UL / fps;
+	unsigned long next = micros();
+	uint32_t frame = 0;
+
+	while (running) {
+		ILI9486MirrorStats stats;
+		if (mirror.update(&stats) && !quiet) {
+			printf("frame %u: %u px changed, %u px sent in %u windows, diff %u us, transfer %u us\n",
+				frame, stats.changed, stats.sent, stats.windows, stats.diffTime, stats.transferTime);
+			fflush(stdout);
+		}
+
+		frame++;
+		next += period;
+
+		unsigned long now = micros();
+		if ((long)(next - now) > 0) {
+			usleep(next - now);
+		} else {
+			next = now;
+		}
+	}
+
+	munmap((void*)source, size);
+	close(descriptor);
+	delete bus;
+	return 0;
+}
@@ -0,0 +1,182 @@
+/*
+pipeline.cpp
+Renders animated plasma and sends it to display twice: serially on one thread
+and through ILI9486Pipeline, where rendering, conversion and transmission
+run on separate threads. Prints frame rates and stage statistics.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+pipeline [--loopback] [--device /dev/spidev0.0] [--gpio /dev/gpiochip0] [--speed 32000000] [--frames 30]
+         [--band 16] [--depth 8] [--dither none|ordered|diffusion]
+
+Pins are the same as in benchmark example.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <ILI9486.h>
+#include <ILI9486Converter.h>
+#include <ILI9486Pipeline.h>
+#include <ILI9486SpidevBus.h>
+#include <ILI9486LoopbackBus.h>
+
+#define CS 8
+#define BL 18
+#define RST 25
+#define DC 24
+
+// Renders rows of plasma frame in XRGB8888 format, rows are packed
+static void render(uint8_t *pixels, uint16_t width, uint16_t y, uint16_t height, uint32_t frame) {
+	float time = frame * 0.1f;
+
+	for (uint16_t row = 0; row < height; row++) {
+		uint32_t *line = (uint32_t*)pixels + (uint32_t)row * width;
+		float fy = (y + row) * 0.02f;
+
+		for (uint16_t x = 0; x < width; x++) {
+			float fx = x * 0.02f;
+			float value = sinf(fx + time) + sinf(fy - time) + sinf((fx + fy) * 0.7f + time) + sinf(sqrtf(fx * fx + fy * fy) * 1.5f);
+
+			uint8_t r = 127.5f + 127.5f * sinf(value * 3.14159f);
+			uint8_t g = 127.5f + 127.5f * sinf(value * 3.14159f + 2.094f);
+			uint8_t b = 127.5f + 127.5f * sinf(value * 3.14159f + 4.189f);
+			line[x] = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	const char *device = "/dev/spidev0.0";
+	const char *gpio = "/dev/gpiochip0";
+	uint32_t speed = 32000000;
+	uint32_t frames = 30;
+	uint16_t bandHeight = 16;
+	uint8_t depth = 8;
+	ILI9486Converter::Dither dither = ILI9486Converter::NO_DITHER;
+	bool loopback = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--loopback") == 0) {
+			loopback = true;
+		} else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+			device = argv[++i];
+		} else if (strcmp(argv[i], "--gpio") == 0 && i + 1 < argc) {
+			gpio = argv[++i];
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			frames = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--band") == 0 && i + 1 < argc) {
+			bandHeight = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+			depth = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--dither") == 0 && i + 1 < argc) {
+			i++;
+			dither = strcmp(argv[i], "ordered") == 0 ? ILI9486Converter::ORDERED_DITHER :
+				(strcmp(argv[i], "diffusion") == 0 ? ILI9486Converter::DIFFUSION_DITHER : ILI9486Converter::NO_DITHER);
+		} else {
+			fprintf(stderr, "usage: %s [--loopback] [--device PATH] [--gpio PATH] [--speed HZ] [--frames N]\n"
+				"       [--band ROWS] [--depth BANDS] [--dither none|ordered|diffusion]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (bandHeight == 0) {
+		bandHeight = 1;
+	}
+	if (depth < 2) {
+		depth = 2;
+	}
+
+	ILI9486Bus *bus;
+	if (loopback) {
+		// Simulated link of given speed, 0 measures library alone
+		bus = new ILI9486LoopbackBus(CS, DC, speed);
+	} else {
+		ILI9486SpidevBus *spidev = new ILI9486SpidevBus(device, gpio, CS, DC, speed);
+		if (!spidev->isOpen()) { return 1; }
+		bus = spidev;
+	}
+
+	SPI.setBus(bus);
+	ILI9486 display(CS, BL, RST, DC, ILI9486::L2R_U2D, 255);
+
+	uint16_t width = display.getWidth();
+	uint16_t height = display.getHeight();
+
+	// Serial: every band is rendered, converted and sent before next one is rendered
+	ILI9486Converter converter(ILI9486Converter::XRGB8888, dither, width);
+	uint8_t *pixels = new uint8_t[(uint32_t)width * bandHeight * 4];
+
+	unsigned long start = micros();
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		for (uint16_t y = 0; y < height; y += bandHeight) {
+			uint16_t rows = height - y < bandHeight ? height - y : bandHeight;
+			render(pixels, width, y, rows, frame);
+
+			display.openWindow(0, y, width, y + rows);
+			for (uint16_t row = 0; row < rows; row++) {
+				converter.write(&display, pixels + (uint32_t)row * width * 4, width, 0, y + row);
+			}
+		}
+	}
+	SPI.flush();
+	unsigned long serial = micros() - start;
+
+	printf("serial     %6.1f fps\n", frames / (serial / 1e6));
+
+	// Pipelined: application only renders, bands of previous rows are converted and sent meanwhile
+	ILI9486Pipeline *pipeline = new ILI9486Pipeline(&display, ILI9486Converter::XRGB8888, dither, bandHeight, depth);
+
+	start = micros();
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		for (uint16_t y = 0; y < height; y += bandHeight) {
+			uint16_t rows = height - y < bandHeight ? height - y : bandHeight;
+
+			ILI9486Band *band = pipeline->acquire();
+			render(band->pixels, width, y, rows, frame);
+			pipeline->submit(band, 0, y, width, rows);
+		}
+	}
+	pipeline->flush();
+	unsigned long pipelined = micros() - start;
+
+	ILI9486PipelineStats stats;
+	pipeline->getStats(&stats);
+	delete pipeline;
+
+	printf("pipelined  %6.1f fps (%.2fx)\n", frames / (pipelined / 1e6), (double)serial / pipelined);
+	printf("%u bands, per band: render %u us, convert %u us, transmit %u us, latency %u us\n",
+		stats.bands, stats.renderTime, stats.convertTime, stats.transmitTime, stats.latency);
+	printf("queue depth: rendered max %u, converted max %u, application stalled %u us\n",
+		stats.maxRendered, stats.maxConverted, stats.stallTime);
+
+	// Last frame rendered again and compared with display through memory read command
+	render(pixels, width, 100, 1, frames - 1);
+	ILI9486_COLOR expected[64], line[64];
+	converter.convert(pixels, expected, 64, 0, 100);
+	display.saveRegion(0, 100, 64, 101, line);
+	bool match = dither == ILI9486Converter::DIFFUSION_DITHER || memcmp(line, expected, sizeof(line)) == 0;
+	printf("read back: %s\n", match ? "ok" : "mismatch");
+
+	delete[] pixels;
+	delete bus;
+	return 0;
+}
@@ -0,0 +1,170 @@
+/*
+player.cpp
+Plays RGB565 video file on display and prints number of shown and dropped
+frames and achieved frame rate. Can also generate test video.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+player FILE [--raw WxH] [--little-endian] [--fps N] [--loop] [--position X,Y]
+       [--generate FRAMES] [--loopback] [--device /dev/spidev0.0] [--gpio /dev/gpiochip0] [--speed 32000000]
+
+--raw plays file without header (for example made with ffmpeg -pix_fmt rgb565be -f rawvideo),
+--little-endian raw frames are swapped while sent instead of being sent straight from file,
+--generate writes framed test video of display size to FILE before playing it.
+Pins are the same as in benchmark example.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#include <ILI9486.h>
+#include <ILI9486Video.h>
+#include <ILI9486SpidevBus.h>
+#include <ILI9486LoopbackBus.h>
+
+#define CS 8
+#define BL 18
+#define RST 25
+#define DC 24
+
+static ILI9486Video *video = NULL;
+
+static void stop(int signal) {
+	video->stop();
+}
+
+// Writes color bars moving by 4 pixels every frame, pixels most significant byte first
+static bool generate(const char *path, uint16_t width, uint16_t height, uint32_t frames, uint16_t fps) {
+	FILE *file = fopen(path, "wb");
+	if (file == NULL) {
+		perror(path);
+		return false;
+	}
+
+	ILI9486VideoHeader header;
+	memcpy(header.magic, ILI9486_VIDEO_MAGIC, 4);
+	header.width = width;
+	header.height = height;
+	header.fps = fps;
+	header.flags = ILI9486_VIDEO_BIG_ENDIAN;
+	header.frames = frames;
+	fwrite(&header, sizeof(header), 1, file);
+
+	static const ILI9486_COLOR bars[] = {0xFFFF, 0xFFE0, 0x07FF, 0x07E0, 0xF81F, 0xF800, 0x001F, 0x0000};
+	uint8_t *row = new uint8_t[width * 2];
+
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		for (uint16_t y = 0; y < height; y++) {
+			for (uint16_t x = 0; x < width; x++) {
+				ILI9486_COLOR color = bars[((x + frame * 4) * 8 / width + y * 2 / height) % 8];
+				row[x * 2] = color >> 8;
+				row[x * 2 + 1] = color;
+			}
+			fwrite(row, 2, width, file);
+		}
+	}
+
+	delete[] row;
+	return fclose(file) == 0;
+}
+
+int main(int argc, char **argv) {
+	const char *path = NULL;
+	const char *device = "/dev/spidev0.0";
+	const char *gpio = "/dev/gpiochip0";
+	uint32_t speed = 32000000;
+	uint32_t rawWidth = 0, rawHeight = 0;
+	uint32_t x = 0, y = 0;
+	uint32_t fps = 0;
+	uint32_t generated = 0;
+	bool bigEndian = true;
+	bool loop = false;
+	bool loopback = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--raw") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%ux%u", &rawWidth, &rawHeight);
+		} else if (strcmp(argv[i], "--little-endian") == 0) {
+			bigEndian = false;
+		} else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+			fps = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--loop") == 0) {
+			loop = true;
+		} else if (strcmp(argv[i], "--position") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%u,%u", &x, &y);
+		} else if (strcmp(argv[i], "--generate") == 0 && i + 1 < argc) {
+			generated = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--loopback") == 0) {
+			loopback = true;
+		} else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+			device = argv[++i];
+		} else if (strcmp(argv[i], "--gpio") == 0 && i + 1 < argc) {
+			gpio = argv[++i];
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else if (argv[i][0] != '-' && path == NULL) {
+			path = argv[i];
+		} else {
+			path = NULL;
+			break;
+		}
+	}
+
+	if (path == NULL) {
+		fprintf(stderr, "usage: %s FILE [--raw WxH] [--little-endian] [--fps N] [--loop] [--position X,Y]\n"
+			"       [--generate FRAMES] [--loopback] [--device PATH] [--gpio PATH] [--speed HZ]\n", argv[0]);
+		return 1;
+	}
+
+	ILI9486Bus *bus;
+	if (loopback) {
+		bus = new ILI9486LoopbackBus(CS, DC, speed);
+	} else {
+		ILI9486SpidevBus *spidev = new ILI9486SpidevBus(device, gpio, CS, DC, speed);
+		if (!spidev->isOpen()) { return 1; }
+		bus = spidev;
+	}
+
+	SPI.setBus(bus);
+	ILI9486 display(CS, BL, RST, DC, ILI9486::L2R_U2D, 255);
+
+	if (generated > 0 && !generate(path, display.getWidth(), display.getHeight(), generated, 30)) { return 1; }
+
+	video = new ILI9486Video(&display);
+	bool opened = rawWidth > 0 ? video->openRaw(path, rawWidth, rawHeight, bigEndian) : video->open(path);
+	if (!opened) { return 1; }
+
+	printf("%s: %u frames %ux%u, %u fps\n", path, video->getFrames(), video->getWidth(), video->getHeight(), video->getFps());
+
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+
+	ILI9486VideoStats stats = {};
+	if (!video->play(x, y, &stats, fps, loop) && stats.shown == 0) {
+		fprintf(stderr, "video doesn't fit on %ux%u display at %u,%u\n", display.getWidth(), display.getHeight(), x, y);
+		return 1;
+	}
+
+	printf("%u frames shown, %u dropped in %u ms, %.1f fps, %u us per frame transfer\n",
+		stats.shown, stats.dropped, stats.time, stats.fps, stats.transferTime);
+
+	delete video;
+	delete bus;
+	return 0;
+}
@@ -0,0 +1,164 @@
+/*
+readback.cpp
+Writes known pixels in every orientation and checks what getPixel, readBuffer (whole and
+continued in chunks) and saveRegion return. Checks dummy byte handling and 18 bit read format
+of memory read commands, runs on loopback bus by default.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+readback [--spidev [--device /dev/spidev0.0] [--gpio /dev/gpiochip0] [--speed 16000000]]
+
+Pins are the same as in benchmark example. Returns 0 when every pixel was read back unchanged.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ILI9486.h>
+#include <ILI9486SpidevBus.h>
+#include <ILI9486LoopbackBus.h>
+
+#define CS 8
+#define BL 18
+#define RST 25
+#define DC 24
+
+// Chunks of continued read, sizes don't divide rows, so reads continue in the middle of lines
+static const uint32_t chunks[] = {1, 7, 319, 1000, 4096};
+
+// RGB565 colors survive 18 bit read format, every pixel of pattern is different along lines and columns
+static ILI9486_COLOR pattern(uint16_t x, uint16_t y) {
+	return (ILI9486_COLOR)((x * 0x9E37u) ^ (y * 0x7F4Bu) ^ (x * y));
+}
+
+static uint32_t compare(const char *name, const ILI9486_COLOR *read, uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+	uint32_t errors = 0;
+	uint32_t i = 0;
+
+	for (uint16_t y = yStart; y < yEnd; y++) {
+		for (uint16_t x = xStart; x < xEnd; x++, i++) {
+			ILI9486_COLOR expected = pattern(x, y);
+			if (read[i] == expected) { continue; }
+
+			if (errors < 4) {
+				fprintf(stderr, "  %s: (%u, %u) read %04X, written %04X\n", name, x, y, read[i], expected);
+			}
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static uint32_t check(ILI9486 *display, ILI9486::Orientation orientation, const char *orientationName) {
+	display->setOrientation(orientation);
+	uint16_t width = display->getWidth();
+	uint16_t height = display->getHeight();
+
+	// Known pixels are written row by row
+	ILI9486_COLOR *row = new ILI9486_COLOR[width];
+	display->openWindow(0, 0, width, height);
+	for (uint16_t y = 0; y < height; y++) {
+		for (uint16_t x = 0; x < width; x++) {
+			row[x] = pattern(x, y);
+		}
+		display->writeBuffer(row, width);
+	}
+	delete[] row;
+
+	ILI9486_COLOR *read = new ILI9486_COLOR[(uint32_t)width * height];
+	uint32_t errors = 0;
+
+	// Single pixels at corners and inside
+	const uint16_t points[][2] = {{0, 0}, {(uint16_t)(width - 1), 0}, {0, (uint16_t)(height - 1)}, {(uint16_t)(width - 1), (uint16_t)(height - 1)}, {(uint16_t)(width / 3), (uint16_t)(height / 2)}};
+	for (uint8_t i = 0; i < 5; i++) {
+		ILI9486_COLOR color = display->getPixel(points[i][0], points[i][1]);
+		errors += compare("getPixel", &color, points[i][0], points[i][1], points[i][0] + 1, points[i][1] + 1);
+	}
+
+	// Whole screen with one memory read
+	display->openReadWindow(0, 0, width, height);
+	display->readBuffer(read, (uint32_t)width * height);
+	errors += compare("readBuffer", read, 0, 0, width, height);
+
+	// Whole screen with memory read continued in chunks
+	memset(read, 0, (uint32_t)width * height * sizeof(ILI9486_COLOR));
+	display->openReadWindow(0, 0, width, height);
+	uint32_t done = 0;
+	for (uint8_t i = 0; done < (uint32_t)width * height; i = (i + 1) % (sizeof(chunks) / sizeof(chunks[0]))) {
+		uint32_t n = chunks[i] < (uint32_t)width * height - done ? chunks[i] : (uint32_t)width * height - done;
+		display->readBuffer(read + done, n);
+		done += n;
+	}
+	errors += compare("chunked readBuffer", read, 0, 0, width, height);
+
+	// Region not starting at origin
+	uint16_t xStart = width / 5, yStart = height / 7, xEnd = width - 3, yEnd = height / 2 + 11;
+	display->saveRegion(xStart, yStart, xEnd, yEnd, read);
+	errors += compare("saveRegion", read, xStart, yStart, xEnd, yEnd);
+
+	delete[] read;
+
+	printf("%-8s %ux%u: %s\n", orientationName, width, height, errors == 0 ? "ok" : "MISMATCH");
+	return errors;
+}
+
+int main(int argc, char **argv) {
+	const char *device = "/dev/spidev0.0";
+	const char *gpio = "/dev/gpiochip0";
+	uint32_t speed = 16000000;
+	bool spidev = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--spidev") == 0) {
+			spidev = true;
+		} else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+			device = argv[++i];
+		} else if (strcmp(argv[i], "--gpio") == 0 && i + 1 < argc) {
+			gpio = argv[++i];
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [--spidev [--device PATH] [--gpio PATH] [--speed HZ]]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	ILI9486Bus *bus;
+	if (spidev) {
+		ILI9486SpidevBus *spidevBus = new ILI9486SpidevBus(device, gpio, CS, DC, speed);
+		if (!spidevBus->isOpen()) { return 1; }
+		bus = spidevBus;
+	} else {
+		bus = new ILI9486LoopbackBus(CS, DC);
+	}
+
+	SPI.setBus(bus);
+	ILI9486 display(CS, BL, RST, DC, ILI9486::L2R_U2D, 255, ILI9486_BLACK, false);
+	printf("ID %06X\n", display.readID());
+
+	const char *names[] = {"L2R_U2D", "L2R_D2U", "R2L_U2D", "R2L_D2U", "U2D_L2R", "U2D_R2L", "D2U_L2R", "D2U_R2L"};
+
+	uint32_t errors = 0;
+	for (uint8_t i = 0; i < 8; i++) {
+		errors += check(&display, (ILI9486::Orientation)i, names[i]);
+	}
+
+	delete bus;
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/*
+screen.cpp
+Draws screen compiled by tools/screencompile.py from file and prints time of
+drawing and amount of data sent to display.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Usage:
+screen FILE [--position X,Y] [--loopback [--gram PATH]] [--device /dev/spidev0.0] [--gpio /dev/gpiochip0] [--speed 32000000]
+
+Pins are the same as in benchmark example.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ILI9486.h>
+#include <ILI9486Screen.h>
+#include <ILI9486SpidevBus.h>
+#include <ILI9486LoopbackBus.h>
+
+#define CS 8
+#define BL 18
+#define RST 25
+#define DC 24
+
+int main(int argc, char **argv) {
+	const char *path = NULL;
+	const char *gram = NULL;
+	const char *device = "/dev/spidev0.0";
+	const char *gpio = "/dev/gpiochip0";
+	uint32_t speed = 32000000;
+	int32_t x = 0, y = 0;
+	bool loopback = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--position") == 0 && i + 1 < argc) {
+			sscanf(argv[++i], "%d,%d", &x, &y);
+		} else if (strcmp(argv[i], "--loopback") == 0) {
+			loopback = true;
+		} else if (strcmp(argv[i], "--gram") == 0 && i + 1 < argc) {
+			gram = argv[++i];
+		} else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+			device = argv[++i];
+		} else if (strcmp(argv[i], "--gpio") == 0 && i + 1 < argc) {
+			gpio = argv[++i];
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = strtoul(argv[++i], NULL, 0);
+		} else if (argv[i][0] != '-' && path == NULL) {
+			path = argv[i];
+		} else {
+			path = NULL;
+			break;
+		}
+	}
+
+	if (path == NULL) {
+		fprintf(stderr, "usage: %s FILE [--position X,Y] [--loopback [--gram PATH]] [--device PATH] [--gpio PATH] [--speed HZ]\n", argv[0]);
+		return 1;
+	}
+
+	// Bytecode is read from RAM, like screen compiled into array without PROGMEM
+	FILE *file = fopen(path, "rb");
+	if (file == NULL) {
+		perror(path);
+		return 1;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	uint8_t *data = new uint8_t[size + 1];
+	data[size] = ILI9486Screen::END;
+	if (fread(data, 1, size, file) != (size_t)size) {
+		perror(path);
+		return 1;
+	}
+	fclose(file);
+
+	ILI9486Bus *bus;
+	if (loopback) {
+		bus = new ILI9486LoopbackBus(CS, DC, speed, gram);
+	} else {
+		ILI9486SpidevBus *spidev = new ILI9486SpidevBus(device, gpio, CS, DC, speed);
+		if (!spidev->isOpen()) { return 1; }
+		bus = spidev;
+	}
+
+	SPI.setBus(bus);
+	ILI9486 display(CS, BL, RST, DC, ILI9486::L2R_U2D, 255, ILI9486_BLACK, false);
+
+	ILI9486Screen screen(&display, data, false);
+	if (!screen.isValid()) {
+		fprintf(stderr, "%s: not a compiled screen\n", path);
+		return 1;
+	}
+
+	uint64_t bytes = SPI.getBytes();
+	unsigned long start = micros();
+
+	bool complete = screen.draw(x, y);
+	SPI.flush();
+
+	unsigned long time = micros() - start;
+	printf("%s: %ld bytes of bytecode drawn in %lu us, %.1f kB sent%s\n", path, size, time,
+		(SPI.getBytes() - bytes) / 1024.0, complete ? "" : ", unknown opcode found");
+
+	delete bus;
+	delete[] data;
+	return complete ? 0 : 1;
+}
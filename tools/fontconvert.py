@@ -0,0 +1,466 @@
+#!/usr/bin/env python3
+"""
+fontconvert.py
+Host tool converting BDF and TTF fonts to font tables used by ILI9486 class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+BDF fonts are read directly, TTF/OTF fonts need freetype-py (pip install freetype-py).
+BDF fonts are 1 bit, to get anti-aliased table from them use font drawn in larger size
+and --oversample option, which averages NxN pixel blocks into single coverage value.
+
+Fixed cell fonts (sFONT, sAAFONT) are generated by default, --proportional generates sPFONT
+with trimmed glyph boxes and kerning pairs (TTF/OTF only, BDF has no kerning).
+Proportional fonts can contain any set of Unicode characters, see --ranges. To keep only characters
+your program draws, pass its sources with --scan, characters of all string literals are collected.
+With --compress glyph bitmaps of proportional fonts are run-length encoded, see fonts/pfont.h.
+
+Examples:
+    fontconvert.py --bpp 4 --size 16 --name Sans16 DejaVuSans.ttf -o sans16.c
+    fontconvert.py --bpp 2 --oversample 4 --name Terminus12 ter-u48n.bdf -o terminus12.c
+    fontconvert.py --proportional --bpp 1 --size 20 --name Sans20 DejaVuSans.ttf -o sans20.c
+    fontconvert.py --proportional --ranges 0x20-0x7E,ĄąĆćĘęŁłŃńÓóŚśŹźŻżÄäÖöÜüß --name PlDe16 font.bdf
+    fontconvert.py --proportional --compress --scan src/*.cpp --ranges " 0123456789" --name Digits font.bdf
+"""
+
+import argparse
+import re
+import sys
+
+
+# Characters stored in fixed cell tables, same as in sFONT
+FIRST_CHAR = 0x20
+LAST_CHAR = 0x7E
+
+# Characters used in comments to preview coverage values
+SHADES = " .:-=+*#%@"
+
+
+class Glyph:
+    """Single character bitmap with metrics relative to baseline, coverage values from 0 to 255."""
+
+    def __init__(self, codepoint, width, height, xoff, yoff, advance, rows):
+        self.codepoint = codepoint
+        self.width = width
+        self.height = height
+        self.xoff = xoff  # Left edge of bitmap relative to pen position
+        self.yoff = yoff  # Bottom edge of bitmap relative to baseline, positive upwards
+        self.advance = advance
+        self.rows = rows  # height lists of width coverage values
+
+
+class Font:
+    def __init__(self, ascent, descent, glyphs, kerning=None):
+        self.ascent = ascent
+        self.descent = descent
+        self.glyphs = glyphs  # codepoint -> Glyph
+        self.kerning = kerning or {}  # (left codepoint, right codepoint) -> adjust [px]
+
+
+def load_bdf(path):
+    glyphs = {}
+    ascent = descent = None
+    glyph = None
+    bitmap = None
+
+    with open(path, encoding="latin-1") as f:
+        for line in f:
+            parts = line.split()
+            if not parts:
+                continue
+            key = parts[0]
+
+            if bitmap is not None and key != "ENDCHAR":
+                bits = int(parts[0], 16)
+                nbits = len(parts[0]) * 4
+                bitmap.append([255 if bits & (1 << (nbits - 1 - i)) else 0 for i in range(glyph["w"])])
+            elif key == "FONT_ASCENT":
+                ascent = int(parts[1])
+            elif key == "FONT_DESCENT":
+                descent = int(parts[1])
+            elif key == "STARTCHAR":
+                glyph = {"advance": 0}
+            elif key == "ENCODING":
+                glyph["codepoint"] = int(parts[1])
+            elif key == "DWIDTH":
+                glyph["advance"] = int(parts[1])
+            elif key == "BBX":
+                glyph["w"], glyph["h"], glyph["xoff"], glyph["yoff"] = map(int, parts[1:5])
+            elif key == "BITMAP":
+                bitmap = []
+            elif key == "ENDCHAR":
+                if glyph["codepoint"] >= 0:
+                    glyphs[glyph["codepoint"]] = Glyph(glyph["codepoint"], glyph["w"], glyph["h"], glyph["xoff"],
+                                                       glyph["yoff"], glyph["advance"], bitmap)
+                glyph = bitmap = None
+
+    if ascent is None or descent is None:
+        ascent = max(g.yoff + g.height for g in glyphs.values())
+        descent = max(-g.yoff for g in glyphs.values())
+
+    return Font(ascent, descent, glyphs)
+
+
+def load_ttf(path, size, codepoints, mono):
+    try:
+        import freetype
+    except ImportError:
+        sys.exit("fontconvert: freetype-py is needed for TTF/OTF fonts (pip install freetype-py)")
+
+    face = freetype.Face(path)
+    face.set_pixel_sizes(0, size)
+    kerning = {}
+    flags = freetype.FT_LOAD_RENDER | (freetype.FT_LOAD_TARGET_MONO if mono else 0)
+    glyphs = {}
+
+    for cp in codepoints:
+        if face.get_char_index(cp) == 0 and cp != FIRST_CHAR:
+            continue
+
+        face.load_char(chr(cp), flags)
+        slot = face.glyph
+        bmp = slot.bitmap
+        rows = []
+
+        for r in range(bmp.rows):
+            line = bmp.buffer[r * bmp.pitch:(r + 1) * bmp.pitch]
+            if bmp.pixel_mode == freetype.FT_PIXEL_MODE_MONO:
+                rows.append([255 if line[i // 8] & (0x80 >> (i % 8)) else 0 for i in range(bmp.width)])
+            else:
+                rows.append(list(line[:bmp.width]))
+
+        glyphs[cp] = Glyph(cp, bmp.width, bmp.rows, slot.bitmap_left, slot.bitmap_top - bmp.rows,
+                           slot.advance.x >> 6, rows)
+
+    if face.has_kerning:
+        for left in glyphs:
+            for right in glyphs:
+                adjust = face.get_kerning(face.get_char_index(left), face.get_char_index(right)).x >> 6
+                if adjust:
+                    kerning[(left, right)] = adjust
+
+    return Font(face.size.ascender >> 6, -(face.size.descender >> 6), glyphs, kerning)
+
+
+def cell_bitmaps(font, codepoints):
+    """Place every glyph in fixed size cell, returns (width, height, {codepoint: rows})."""
+    present = [font.glyphs[cp] for cp in codepoints if cp in font.glyphs]
+    # Glyphs with negative left bearing (j, italics) move every glyph right, so their ink stays in cell
+    shift = -min(min(g.xoff for g in present), 0)
+    width = max(max(shift + g.advance, shift + g.xoff + g.width) for g in present)
+    height = font.ascent + font.descent
+    cells = {}
+
+    for cp in codepoints:
+        cell = [[0] * width for _ in range(height)]
+        g = font.glyphs.get(cp)
+
+        if g is not None:
+            top = font.ascent - (g.yoff + g.height)
+            for r in range(g.height):
+                for c in range(g.width):
+                    y, x = top + r, shift + g.xoff + c
+                    if 0 <= y < height and 0 <= x < width:
+                        cell[y][x] = max(cell[y][x], g.rows[r][c])
+
+        cells[cp] = cell
+
+    return width, height, cells
+
+
+def downsample(width, height, cells, factor):
+    """Average factor x factor blocks of pixels into single coverage value."""
+    w = (width + factor - 1) // factor
+    h = (height + factor - 1) // factor
+    result = {}
+
+    for cp, cell in cells.items():
+        rows = []
+        for y in range(h):
+            row = []
+            for x in range(w):
+                total = 0
+                for dy in range(factor):
+                    for dx in range(factor):
+                        sy, sx = y * factor + dy, x * factor + dx
+                        if sy < height and sx < width:
+                            total += cell[sy][sx]
+                row.append(total // (factor * factor))
+            rows.append(row)
+        result[cp] = rows
+
+    return w, h, result
+
+
+def quantize(value, bpp):
+    levels = (1 << bpp) - 1
+    return (value * levels + 127) // 255
+
+
+def pack_line(row, bpp):
+    """Pack coverage values most significant bits first, line padded to full byte."""
+    data = []
+    bits = used = 0
+
+    for value in row:
+        bits = (bits << bpp) | quantize(value, bpp)
+        used += bpp
+        if used == 8:
+            data.append(bits)
+            bits = used = 0
+
+    if used:
+        data.append(bits << (8 - used))
+
+    return data
+
+
+def preview(row, bpp):
+    levels = (1 << bpp) - 1
+    return "".join(SHADES[quantize(v, bpp) * (len(SHADES) - 1) // levels] for v in row)
+
+
+def char_repr(cp):
+    return "'%s'" % chr(cp) if 0x20 <= cp < 0x7F and chr(cp) not in "'\\" else "U+%04X" % cp
+
+
+def trim(rows):
+    """Find inked box of cell, returns (left, top, width, height)."""
+    inked = [(y, x) for y, row in enumerate(rows) for x, v in enumerate(row) if v]
+    if not inked:
+        return 0, 0, 0, 0
+
+    top = min(y for y, _ in inked)
+    left = min(x for _, x in inked)
+    return left, top, max(x for _, x in inked) - left + 1, max(y for y, _ in inked) - top + 1
+
+
+def parse_ranges(text):
+    """Parse comma separated list of ranges (0x20-0x7E) and literal characters."""
+    codepoints = set()
+
+    for part in text.split(","):
+        if part.lower().startswith("0x") or part.lower().startswith("u+"):
+            bounds = [int(b[2:], 16) for b in part.split("-")]
+            codepoints.update(range(bounds[0], bounds[-1] + 1))
+        else:
+            codepoints.update(ord(c) for c in part)
+
+    return sorted(codepoints)
+
+
+def scan_literals(paths):
+    """Collect characters of all string literals in source files, escape sequences are skipped."""
+    chars = set()
+
+    for path in paths:
+        with open(path, encoding="utf-8") as f:
+            for literal in re.findall(r'"((?:[^"\\\n]|\\.)*)"', f.read()):
+                chars.update(re.sub(r"\\(x[0-9a-fA-F]+|[0-7]{1,3}|.)", "", literal))
+
+    return sorted(ord(c) for c in chars)
+
+
+def rle_encode(values, bpp):
+    """Run-length encode coverage values, runs can cross lines.
+
+    1 bit: runs of alternating background and foreground pixels, starting with background,
+    4 bits per run (0 - 15 pixels), first run in most significant bits of byte.
+    2 and 4 bits: one byte per run, value in Bpp most significant bits, run length - 1 in remaining bits.
+    """
+    runs = []
+    for v in values:
+        q = quantize(v, bpp)
+        if runs and runs[-1][0] == q:
+            runs[-1][1] += 1
+        else:
+            runs.append([q, 1])
+
+    data = []
+    if bpp == 1:
+        nibbles = []
+        current = 0
+        for value, length in runs:
+            if value != current:
+                nibbles.append(0)
+                current = value
+            while length > 15:
+                nibbles += [15, 0]
+                length -= 15
+            nibbles.append(length)
+            current ^= 1
+        if len(nibbles) % 2:
+            nibbles.append(0)
+        data = [(nibbles[i] << 4) | nibbles[i + 1] for i in range(0, len(nibbles), 2)]
+    else:
+        longest = 1 << (8 - bpp)
+        for value, length in runs:
+            while length > 0:
+                run = min(length, longest)
+                data.append((value << (8 - bpp)) | (run - 1))
+                length -= run
+
+    return data
+
+
+def write_proportional_font(out, name, height, cells, advances, kerning, bpp, compress, source):
+    codepoints = sorted(cells)
+    first, last = codepoints[0], codepoints[-1]
+    index = {cp: i for i, cp in enumerate(codepoints)}
+
+    # Sparse fonts need sorted codepoints index
+    sparse = codepoints != list(range(first, last + 1))
+
+    out.write("/*\n%s font generated by tools/fontconvert.py from %s\n*/\n\n" % (name, source))
+    out.write('#include "pfont.h"\n#include <avr/pgmspace.h>\n#include <stddef.h>\n\n')
+    out.write("// Declare in your program with: extern sPFONT %s;\n\n" % name)
+    out.write("const uint8_t %s_Table[] PROGMEM = \n{\n" % name)
+
+    boxes = []
+    for cp in codepoints:
+        rows = cells[cp]
+        left, top, w, h = trim(rows)
+        box = [row[left:left + w] for row in rows[top:top + h]]
+
+        # Lines are stored from bottom to top as one continuous stream
+        values = [v for row in reversed(box) for v in row]
+        boxes.append((cp, left, top, w, h, box, pack_line(values, bpp), rle_encode(values, bpp) if values else []))
+
+    # Run-length encoding is used only if it makes bitmaps smaller
+    raw = sum(len(b[6]) for b in boxes)
+    if compress and sum(len(b[7]) for b in boxes) >= raw:
+        sys.stderr.write("%s: run-length encoding does not make bitmaps smaller, writing them uncompressed\n" % name)
+        compress = False
+
+    glyphs = []
+    offset = 0
+    for cp, left, top, w, h, box, packed, encoded in boxes:
+        data = encoded if compress else packed
+        out.write("\t// @%d %s (%dx%d)\n" % (offset, char_repr(cp), w, h))
+        for row in box:
+            out.write("\t// %s\n" % preview(row, bpp))
+        if data:
+            out.write("\t%s,\n" % ", ".join("0x%02X" % b for b in data))
+        out.write("\n")
+
+        glyphs.append((offset, w, h, advances.get(cp, 0), left, top, cp))
+        offset += len(data)
+
+    out.write("};\n\nconst sGLYPH %s_Glyphs[] PROGMEM = \n{\n" % name)
+    for g in glyphs:
+        out.write("\t{%d, %d, %d, %d, %d, %d}, // %s\n" % (g[:6] + (char_repr(g[6]),)))
+    out.write("};\n\n")
+
+    pairs = sorted((index[l], index[r], a) for (l, r), a in kerning.items() if l in index and r in index)
+    if pairs:
+        out.write("const sKERNPAIR %s_Kerning[] PROGMEM = \n{\n" % name)
+        for l, r, a in pairs:
+            out.write("\t{%d, %d, %d},\n" % (l, r, a))
+        out.write("};\n\n")
+
+    if sparse:
+        out.write("const uint16_t %s_Codepoints[] PROGMEM = \n{\n" % name)
+        for i in range(0, len(codepoints), 8):
+            out.write("\t%s,\n" % ", ".join("0x%04X" % cp for cp in codepoints[i:i + 8]))
+        out.write("};\n\n")
+
+    out.write("sPFONT %s = {\n  %s_Table,\n  %s_Glyphs,\n" % (name, name, name))
+    out.write("  %s,\n  %d, /* Kerning pairs */\n" % ("%s_Kerning" % name if pairs else "NULL", len(pairs)))
+    out.write("  0x%02X, /* First */\n  0x%02X, /* Last */\n  %d, /* Height */\n  %d, /* Bpp */\n" % (first, last, height, bpp))
+    out.write("  %s,\n  %d, /* Glyphs */\n" % ("%s_Codepoints" % name if sparse else "NULL", len(codepoints)))
+    out.write("  %s,\n};\n" % ("PFONT_RLE" if compress else "PFONT_RAW"))
+
+    # Flash use summary
+    tables = len(glyphs) * 10 + len(pairs) * 5 + (len(codepoints) * 2 if sparse else 0)
+    sys.stderr.write("%s: %d glyphs, bitmaps %d bytes (%d uncompressed), other tables %d bytes\n"
+                     % (name, len(glyphs), offset, raw, tables))
+
+
+def write_cell_font(out, name, width, height, cells, bpp, source):
+    struct = "sFONT" if bpp == 1 else "sAAFONT"
+    header = "fonts.h" if bpp == 1 else "aafont.h"
+
+    out.write("/*\n%s font generated by tools/fontconvert.py from %s\n*/\n\n" % (name, source))
+    out.write('#include "%s"\n#include <avr/pgmspace.h>\n\n' % header)
+    out.write("// Declare in your program with: extern %s %s;\n\n" % (struct, name))
+    out.write("const uint8_t %s_Table[] PROGMEM = \n{\n" % name)
+
+    offset = 0
+    for cp in range(FIRST_CHAR, LAST_CHAR + 1):
+        out.write("\t// @%d %s (%d pixels wide)\n" % (offset, char_repr(cp), width))
+        for row in cells[cp]:
+            data = pack_line(row, bpp)
+            out.write("\t%s, // %s\n" % (", ".join("0x%02X" % b for b in data), preview(row, bpp)))
+            offset += len(data)
+        out.write("\n")
+
+    out.write("};\n\n%s %s = {\n  %s_Table,\n  %d, /* Width */\n  %d, /* Height */\n" % (struct, name, name, width, height))
+    if bpp != 1:
+        out.write("  %d, /* Bpp */\n" % bpp)
+    out.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert BDF/TTF font to ILI9486 font table")
+    parser.add_argument("source", help="BDF, TTF or OTF font file")
+    parser.add_argument("--name", required=True, help="name of generated font variable")
+    parser.add_argument("--bpp", type=int, choices=(1, 2, 4), default=4, help="bits per pixel, 1 generates sFONT, 2 and 4 sAAFONT")
+    parser.add_argument("--size", type=int, default=16, help="pixel height for TTF/OTF fonts")
+    parser.add_argument("--proportional", action="store_true", help="generate sPFONT with trimmed glyphs and kerning")
+    parser.add_argument("--ranges", help="characters of proportional font, e.g. 0x20-0x7E,0x104-0x107,ÄÖÜ (default 0x20-0x7E)")
+    parser.add_argument("--scan", nargs="+", metavar="FILE", help="keep only characters used in string literals of given sources (and --ranges)")
+    parser.add_argument("--compress", action="store_true", help="run-length encode bitmaps of proportional font")
+    parser.add_argument("--oversample", type=int, default=1, help="average NxN source pixels into one pixel")
+    parser.add_argument("-o", "--output", help="output C file, standard output by default")
+    args = parser.parse_args()
+
+    codepoints = list(range(FIRST_CHAR, LAST_CHAR + 1))
+    if args.proportional:
+        if args.scan:
+            codepoints = sorted(set(scan_literals(args.scan)) | set(parse_ranges(args.ranges) if args.ranges else []))
+        elif args.ranges:
+            codepoints = parse_ranges(args.ranges)
+    elif args.ranges or args.scan or args.compress:
+        parser.error("--ranges, --scan and --compress need --proportional, fixed cell fonts contain printable ASCII characters")
+
+    if args.source.lower().endswith(".bdf"):
+        font = load_bdf(args.source)
+    else:
+        font = load_ttf(args.source, args.size * args.oversample, codepoints, args.bpp == 1 and args.oversample == 1)
+
+    if args.proportional:
+        codepoints = [cp for cp in codepoints if cp in font.glyphs]
+
+    width, height, cells = cell_bitmaps(font, codepoints)
+    if args.oversample > 1:
+        width, height, cells = downsample(width, height, cells, args.oversample)
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    source = args.source.split("/")[-1]
+
+    if args.proportional:
+        factor = args.oversample
+        advances = {cp: (g.advance + factor - 1) // factor for cp, g in font.glyphs.items()}
+        kerning = {pair: a // factor for pair, a in font.kerning.items() if a // factor}
+        write_proportional_font(out, args.name, height, cells, advances, kerning, args.bpp, args.compress, source)
+    else:
+        write_cell_font(out, args.name, width, height, cells, args.bpp, source)
+    if args.output:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,309 @@
+#!/usr/bin/env python3
+"""
+screencompile.py
+Host tool compiling screen descriptions into drawing bytecode executed by ILI9486Screen class.
+
+Copyright (C) 2024 Mateusz Bogusławski, E: mateusz.boguslawski@ibnet.pl
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see https://www.gnu.org/licenses/.
+
+---
+
+Screen description has one command per line, arguments are the same as of ILI9486 methods,
+text after # is a comment. Colors are RGB565 numbers (0xF800) or names BLACK, WHITE, RED, GREEN, BLUE,
+font sizes are XS, S, M, L, XL, rotations ROTATE_0, ROTATE_90, ROTATE_180, ROTATE_270.
+    clear COLOR
+    fill xStart yStart xEnd yEnd COLOR
+    pixel x y COLOR
+    hline x y len COLOR
+    vline x y len COLOR
+    line xStart yStart xEnd yEnd COLOR
+    circle x y radius COLOR [filled]
+    string x y "text" SIZE COLOR [scale]
+    text x y "text" SIZE COLOR BACKGROUND [ROTATION]
+
+Fills, pixels and lines are compiled to rectangles, clear is fill of --size at origin of draw. Rectangles covered by later ones are dropped,
+rectangles of the same color forming a rectangle together are merged, and rectangles of the same
+color are moved next to each other when they don't overlap anything they are moved over, so they
+are written as one bulk FILLS instruction.
+
+Examples:
+    screencompile.py settings.screen -o settings.iscr
+    screencompile.py --header settings settings.screen -o settings.h
+"""
+
+import argparse
+import shlex
+import sys
+
+
+MAGIC = b"ISCR"
+TEXT_LIMIT = 64  # ILI9486_SCREEN_TEXT
+
+END, COLOR, BACKGROUND, CLEAR, FILL, FILLS, LINE, CIRCLE, FILLED_CIRCLE, STRING, TEXT = range(11)
+
+COLORS = {"BLACK": 0x0000, "WHITE": 0xFFFF, "RED": 0xF000, "GREEN": 0x0F00, "BLUE": 0x00F0}
+SIZES = {"XS": 8, "S": 12, "M": 16, "L": 20, "XL": 24}
+ROTATIONS = {"ROTATE_0": 0, "ROTATE_90": 1, "ROTATE_180": 2, "ROTATE_270": 3}
+
+
+class Rect:
+    """Filled rectangle, exclusive end."""
+
+    def __init__(self, color, x0, y0, x1, y1):
+        self.color = color
+        self.x0, self.y0, self.x1, self.y1 = x0, y0, x1, y1
+
+    def overlaps(self, other):
+        return self.x0 < other.x1 and other.x0 < self.x1 and self.y0 < other.y1 and other.y0 < self.y1
+
+    def contains(self, other):
+        return self.x0 <= other.x0 and self.y0 <= other.y0 and self.x1 >= other.x1 and self.y1 >= other.y1
+
+    def union(self, other):
+        """Rectangle equal to union of both, None if union is not a rectangle."""
+        if self.contains(other):
+            return self
+        if other.contains(self):
+            return other
+        if self.x0 == other.x0 and self.x1 == other.x1 and self.y0 <= other.y1 and other.y0 <= self.y1:
+            return Rect(self.color, self.x0, min(self.y0, other.y0), self.x1, max(self.y1, other.y1))
+        if self.y0 == other.y0 and self.y1 == other.y1 and self.x0 <= other.x1 and other.x0 <= self.x1:
+            return Rect(self.color, min(self.x0, other.x0), self.y0, max(self.x1, other.x1), self.y1)
+        return None
+
+
+class Primitive:
+    """Command other than fill, kept in order with its encoded operands."""
+
+    def __init__(self, color, background, code):
+        self.color = color
+        self.background = background
+        self.code = code
+
+
+def varint(value):
+    if value < 0 or value > 0xFFFF:
+        raise ValueError("number %d out of range 0..65535" % value)
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        out.append(byte | (0x80 if value else 0))
+        if not value:
+            return bytes(out)
+
+
+def parse_color(text):
+    return COLORS[text.upper()] if text.upper() in COLORS else int(text, 0) & 0xFFFF
+
+
+def parse(lines, width, height):
+    """Commands in order, fills as Rect, other commands as Primitive."""
+    commands = []
+
+    for number, line in enumerate(lines, 1):
+        try:
+            args = shlex.split(line, comments=True)
+        except ValueError as e:
+            raise SyntaxError("line %d: %s" % (number, e))
+        if not args:
+            continue
+
+        name, args = args[0].lower(), args[1:]
+        try:
+            if name == "clear":
+                commands.append(Rect(parse_color(args[0]), 0, 0, width, height))
+            elif name == "fill":
+                x0, y0, x1, y1 = (int(a, 0) for a in args[:4])
+                if x1 > x0 and y1 > y0:
+                    commands.append(Rect(parse_color(args[4]), x0, y0, x1, y1))
+            elif name == "pixel":
+                x, y = int(args[0], 0), int(args[1], 0)
+                commands.append(Rect(parse_color(args[2]), x, y, x + 1, y + 1))
+            elif name in ("hline", "vline"):
+                x, y, length = (int(a, 0) for a in args[:3])
+                if length > 0:
+                    x1, y1 = (x + length, y + 1) if name == "hline" else (x + 1, y + length)
+                    commands.append(Rect(parse_color(args[3]), x, y, x1, y1))
+            elif name == "line":
+                x0, y0, x1, y1 = (int(a, 0) for a in args[:4])
+                color = parse_color(args[4])
+                if x0 == x1 and y0 == y1:
+                    pass
+                elif x0 == x1 or y0 == y1:
+                    # Straight line is a rectangle, ILI9486::drawLine doesn't draw end point
+                    xs, xe = (x0, x1 + (x0 == x1)) if x1 >= x0 else (x1 + 1, x0 + 1)
+                    ys, ye = (y0, y1 + (y0 == y1)) if y1 >= y0 else (y1 + 1, y0 + 1)
+                    commands.append(Rect(color, xs, ys, xe, ye))
+                else:
+                    code = bytes([LINE]) + varint(x0) + varint(y0) + varint(x1) + varint(y1)
+                    commands.append(Primitive(color, None, code))
+            elif name == "circle":
+                x, y, radius = (int(a, 0) for a in args[:3])
+                filled = len(args) > 4 and args[4].lower() == "filled"
+                code = bytes([FILLED_CIRCLE if filled else CIRCLE]) + varint(x) + varint(y) + varint(radius)
+                commands.append(Primitive(parse_color(args[3]), None, code))
+            elif name == "string":
+                x, y = int(args[0], 0), int(args[1], 0)
+                text = args[2].encode("utf-8")
+                scale = int(args[5], 0) if len(args) > 5 else 1
+                code = bytes([STRING, SIZES[args[3].upper()], scale]) + varint(x) + varint(y) + text + b"\0"
+                commands.append(Primitive(parse_color(args[4]), None, code))
+            elif name == "text":
+                x, y = int(args[0], 0), int(args[1], 0)
+                text = args[2].encode("utf-8")
+                if len(text) > TEXT_LIMIT:
+                    raise ValueError("text longer than %d bytes" % TEXT_LIMIT)
+                rotation = ROTATIONS[args[6].upper()] if len(args) > 6 else 0
+                code = bytes([TEXT, SIZES[args[3].upper()], rotation]) + varint(x) + varint(y) + varint(len(text)) + text
+                commands.append(Primitive(parse_color(args[4]), parse_color(args[5]), code))
+            else:
+                raise ValueError("unknown command %s" % name)
+        except (IndexError, KeyError, ValueError) as e:
+            raise SyntaxError("line %d: %s" % (number, e))
+
+    return commands
+
+
+def drop_covered(commands):
+    """Rectangle fully covered by later rectangle is never visible."""
+    result = []
+    for i, command in enumerate(commands):
+        if isinstance(command, Rect) and any(isinstance(c, Rect) and c.contains(command) for c in commands[i + 1:]):
+            continue
+        result.append(command)
+    return result
+
+
+def merge(run):
+    """Merge rectangles of the same color in run of fills, merged one takes place of the later one."""
+    merged = True
+    while merged:
+        merged = False
+        for j in range(len(run)):
+            for i in range(j):
+                union = run[i].union(run[j])
+                if run[i].color != run[j].color or union is None:
+                    continue
+                # Moving earlier rectangle forward must not cover rectangles of other colors drawn between
+                if any(r.color != run[i].color and r.overlaps(run[i]) for r in run[i + 1:j]):
+                    continue
+                run[j] = Rect(run[j].color, union.x0, union.y0, union.x1, union.y1)
+                del run[i]
+                merged = True
+                break
+            if merged:
+                break
+    return run
+
+
+def group(run):
+    """Groups of rectangles of the same color, rectangle joins earlier group when it overlaps nothing in between."""
+    groups = []
+    for rect in run:
+        target = None
+        for g in reversed(groups):
+            if g[0].color == rect.color:
+                target = g
+                break
+            if any(r.overlaps(rect) for r in g):
+                break
+        if target is None:
+            groups.append([rect])
+        else:
+            target.append(rect)
+    return groups
+
+
+def compile_screen(commands):
+    commands = drop_covered(commands)
+    out = bytearray(MAGIC)
+    color = None
+    background = None
+    fills = 0
+
+    def set_color(value):
+        nonlocal color
+        if value != color:
+            out.extend(bytes([COLOR]) + value.to_bytes(2, "little"))
+            color = value
+
+    i = 0
+    while i < len(commands):
+        if isinstance(commands[i], Primitive):
+            primitive = commands[i]
+            set_color(primitive.color)
+            if primitive.background is not None and primitive.background != background:
+                out.extend(bytes([BACKGROUND]) + primitive.background.to_bytes(2, "little"))
+                background = primitive.background
+            out.extend(primitive.code)
+            i += 1
+            continue
+
+        # Run of fills between other commands
+        j = i
+        while j < len(commands) and isinstance(commands[j], Rect):
+            j += 1
+        groups = group(merge(list(commands[i:j])))
+        i = j
+
+        for g in groups:
+            set_color(g[0].color)
+            fills += len(g)
+            out.append(FILL if len(g) == 1 else FILLS)
+            if len(g) > 1:
+                out.extend(varint(len(g)))
+            for r in g:
+                out.extend(varint(r.x0) + varint(r.y0) + varint(r.x1 - r.x0) + varint(r.y1 - r.y0))
+
+    out.append(END)
+    return bytes(out), fills
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile screen description to ILI9486Screen bytecode")
+    parser.add_argument("source", help="screen description, standard input for -")
+    parser.add_argument("-o", "--output", required=True, help="output file")
+    parser.add_argument("--header", metavar="NAME", help="write C header with PROGMEM array NAME instead of binary file")
+    parser.add_argument("--size", default="320x480", help="screen size used by clear, WxH (default 320x480)")
+    args = parser.parse_args()
+
+    width, height = (int(v) for v in args.size.lower().split("x"))
+    source = sys.stdin if args.source == "-" else open(args.source, encoding="utf-8")
+    with source:
+        lines = source.readlines()
+
+    try:
+        commands = parse(lines, width, height)
+    except SyntaxError as e:
+        sys.exit("%s: %s" % (args.source, e))
+
+    code, fills = compile_screen(commands)
+
+    if args.header:
+        with open(args.output, "w") as out:
+            out.write("// Compiled from %s by screencompile.py\n#pragma once\n#include <Arduino.h>\n\n" % args.source)
+            out.write("const uint8_t %s[%d] PROGMEM = {" % (args.header, len(code)))
+            for i, byte in enumerate(code):
+                out.write(("\n\t" if i == 0 else (",\n\t" if i % 16 == 0 else ", ")) + "0x%02X" % byte)
+            out.write("\n};\n")
+    else:
+        with open(args.output, "wb") as out:
+            out.write(code)
+
+    rects = sum(1 for c in commands if isinstance(c, Rect))
+    print("%d commands (%d rectangles, %d after merging): %d bytes" % (len(commands), rects, fills, len(code)))
+
+
+if __name__ == "__main__":
+    main()